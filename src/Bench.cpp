@@ -0,0 +1,216 @@
+// microbenchmarks for the solver's hot paths. run from the build directory
+// so answers.txt and guesses.txt are found.
+#include "wordle/CacheFile.h"
+#include "wordle/FeedbackKernels.h"
+#include "wordle/WordList.h"
+#include "wordle/WordleGame.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// the bundled word lists are five letters.
+#define BENCH_WORD_LENGTH 5
+
+typedef Word<BENCH_WORD_LENGTH> BenchWord;
+
+typedef WordleGame<BENCH_WORD_LENGTH> BenchGame;
+
+struct BenchDictionary
+{
+    std::string answersText;
+    std::string guessesText;
+    std::unique_ptr<BenchGame > game;
+    std::unique_ptr<BenchGame > matrixGame;
+};
+
+// loaded once and shared by every benchmark.
+const BenchDictionary &benchDictionary()
+{
+    static BenchDictionary dictionary;
+    if (dictionary.game)
+    {
+        return dictionary;
+    }
+    std::ifstream answersFile("answers.txt");
+    std::ifstream guessesFile("guesses.txt");
+    if (!answersFile.is_open() || !guessesFile.is_open())
+    {
+        throw std::runtime_error("Unable to read word lists");
+    }
+    dictionary.answersText = readFileBytes(answersFile);
+    dictionary.guessesText = readFileBytes(guessesFile);
+    std::istringstream answersStream(dictionary.answersText);
+    std::istringstream guessesStream(dictionary.guessesText);
+    dictionary.game.reset(new BenchGame(
+        readFileLines<BENCH_WORD_LENGTH>(guessesStream), readFileLines<BENCH_WORD_LENGTH>(answersStream)));
+    dictionary.matrixGame = dictionary.game->newGame();
+    dictionary.matrixGame->enableFeedbackMatrix();
+    return dictionary;
+}
+
+// a game partway through solving solution, with numTurns guesses made.
+std::unique_ptr<BenchGame > gameAtTurn(bool useMatrix, int32_t numTurns, const BenchWord &solution)
+{
+    const BenchDictionary &dictionary = benchDictionary();
+    auto game = (useMatrix ? dictionary.matrixGame : dictionary.game)->newGame();
+    for (int32_t turn = 0; turn < numTurns; turn++)
+    {
+        game->pushFeedback(BenchGame::computeFeedback(game->getGuess(), solution));
+    }
+    return game;
+}
+
+void BM_ComputeFeedbackId(benchmark::State &state)
+{
+    const std::vector<BenchWord > &answers = *benchDictionary().game->getAnswerWords();
+    BenchWord guess("roate");
+    for (auto _ : state)
+    {
+        for (const auto &answer : answers)
+        {
+            benchmark::DoNotOptimize(BenchGame::computeFeedbackId(guess, answer));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * answers.size());
+}
+BENCHMARK(BM_ComputeFeedbackId);
+
+// the batched kernels over the packed answers; 0 is the scalar fallback,
+// 1 whatever selectFeedbackKernel picks for this cpu.
+void BM_FeedbackKernel(benchmark::State &state)
+{
+    const std::vector<BenchWord > &answers = *benchDictionary().game->getAnswerWords();
+    PackedAnswers<BENCH_WORD_LENGTH> packedAnswers;
+    packedAnswers.assign(answers);
+    std::vector<FeedbackCell<BENCH_WORD_LENGTH> > feedbackIds(packedAnswers.paddedSize());
+    FeedbackKernel<BENCH_WORD_LENGTH> kernel =
+        state.range(0) == 0 ? computeFeedbackIdsScalar<BENCH_WORD_LENGTH> : selectFeedbackKernel<BENCH_WORD_LENGTH>();
+    uint8_t guessCodes[BENCH_WORD_LENGTH];
+    BenchWord guess("roate");
+    for (std::size_t p = 0; p < BENCH_WORD_LENGTH; p++)
+    {
+        guessCodes[p] = guess.letterCode(p);
+    }
+    for (auto _ : state)
+    {
+        kernel(guessCodes, packedAnswers, feedbackIds.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * answers.size());
+}
+BENCHMARK(BM_FeedbackKernel)->ArgName("simd")->Arg(0)->Arg(1);
+
+void BM_IsConsistentWith(benchmark::State &state)
+{
+    const std::vector<BenchWord > &answers = *benchDictionary().game->getAnswerWords();
+    GuessFeedback<BENCH_WORD_LENGTH> guessFeedback = BenchGame::computeFeedback(BenchWord("roate"), BenchWord("light"));
+    for (auto _ : state)
+    {
+        for (const auto &answer : answers)
+        {
+            benchmark::DoNotOptimize(guessFeedback.isConsistentWith(answer));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * answers.size());
+}
+BENCHMARK(BM_IsConsistentWith);
+
+// the same check compiled into constraints, as pushFeedback filters.
+void BM_ConstraintsAllow(benchmark::State &state)
+{
+    const std::vector<BenchWord > &answers = *benchDictionary().game->getAnswerWords();
+    FeedbackConstraints<BENCH_WORD_LENGTH> constraints(
+        BenchGame::computeFeedback(BenchWord("roate"), BenchWord("light")));
+    for (auto _ : state)
+    {
+        for (const auto &answer : answers)
+        {
+            benchmark::DoNotOptimize(constraints.allows(answer));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * answers.size());
+}
+BENCHMARK(BM_ConstraintsAllow);
+
+// full getGuess for turn range(0) of solving a fixed answer, with and
+// without the matrix. items are guesses scored.
+void BM_GetGuess(benchmark::State &state)
+{
+    auto game = gameAtTurn(state.range(1) != 0, static_cast<int32_t>(state.range(0)) - 1, BenchWord("light"));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(game->getGuess());
+    }
+    state.SetItemsProcessed(state.iterations() * game->getGuessWords()->size());
+    state.counters["candidates"] = static_cast<double>(game->getPossibleAnswers().size());
+}
+BENCHMARK(BM_GetGuess)->ArgNames({"turn", "matrix"})->Args({2, 0})->Args({2, 1})->Args({3, 0})->Args({3, 1})->Unit(benchmark::kMillisecond);
+
+// turn 2 of range(0) games with different answers, scored in one batched
+// pass over the matrix. items are guesses scored.
+void BM_GetGuesses(benchmark::State &state)
+{
+    const std::vector<BenchWord > &answers = *benchDictionary().game->getAnswerWords();
+    std::vector<std::unique_ptr<BenchGame > > ownedGames;
+    std::vector<BenchGame *> games;
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        ownedGames.push_back(gameAtTurn(true, 1, answers[i * 7 % answers.size()]));
+        games.push_back(ownedGames.back().get());
+    }
+    std::vector<BenchWord > guesses;
+    for (auto _ : state)
+    {
+        BenchGame::getGuesses(games, guesses, NULL);
+        benchmark::DoNotOptimize(guesses.data());
+    }
+    state.SetItemsProcessed(state.iterations() * games.size() * games[0]->getGuessWords()->size());
+}
+BENCHMARK(BM_GetGuesses)->ArgName("games")->Arg(1)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
+
+void BM_FeedbackMatrixBuild(benchmark::State &state)
+{
+    const BenchDictionary &dictionary = benchDictionary();
+    const std::vector<BenchWord > &guesses = *dictionary.game->getGuessWords();
+    const std::vector<BenchWord > &answers = *dictionary.game->getAnswerWords();
+    for (auto _ : state)
+    {
+        FeedbackMatrix<BENCH_WORD_LENGTH> matrix(guesses, answers);
+        benchmark::DoNotOptimize(matrix.data());
+    }
+    state.SetItemsProcessed(state.iterations() * guesses.size() * answers.size());
+}
+BENCHMARK(BM_FeedbackMatrixBuild)->Unit(benchmark::kMillisecond);
+
+// the mmap load of a cache file with the matrix in it. items are matrix
+// cells made available.
+void BM_CacheFileLoad(benchmark::State &state)
+{
+    const BenchDictionary &dictionary = benchDictionary();
+    uint64_t sourceChecksum = checksumBytes(dictionary.guessesText, checksumBytes(dictionary.answersText));
+    std::string path = "wordle_bench.cache";
+    std::istringstream answersStream(dictionary.answersText);
+    std::istringstream guessesStream(dictionary.guessesText);
+    writeCacheFile<BENCH_WORD_LENGTH>(
+        path, sourceChecksum, *readFileLines<BENCH_WORD_LENGTH>(answersStream), *readFileLines<BENCH_WORD_LENGTH>(guessesStream),
+        dictionary.matrixGame->getFeedbackMatrix().get(), NULL);
+    for (auto _ : state)
+    {
+        CachedDictionary<BENCH_WORD_LENGTH> cached;
+        if (!loadCacheFile(path, sourceChecksum, cached))
+        {
+            state.SkipWithError("Cache file did not load");
+            break;
+        }
+        benchmark::DoNotOptimize(cached.feedbackMatrix->data());
+    }
+    const FeedbackMatrix<BENCH_WORD_LENGTH> &matrix = *dictionary.matrixGame->getFeedbackMatrix();
+    state.SetItemsProcessed(state.iterations() * matrix.numGuesses() * matrix.numAnswers());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_CacheFileLoad);
+
+BENCHMARK_MAIN();
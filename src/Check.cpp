@@ -0,0 +1,181 @@
+// consistency checks for the solver's fast paths against the plain rules
+// they replace. run from the build directory so answers.txt and guesses.txt
+// are found; exits non-zero if any of them disagree.
+#include "wordle/FeedbackConstraints.h"
+#include "wordle/FeedbackKernels.h"
+#include "wordle/WordleGame.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+// every guess word past the answers this far apart is checked too.
+#define CHECK_GUESS_STRIDE 8
+// guesses with a repeated letter whose every feedback is compiled into
+// constraints.
+#define CHECK_REPEATED_LETTER_GUESSES 16
+
+struct CheckLists
+{
+    std::vector<std::string> answers;
+    std::vector<std::string> guesses;
+};
+
+static std::vector<std::string> readWordStrings(const char *path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        throw std::runtime_error(std::string("Unable to read ") + path);
+    }
+    std::vector<std::string> words;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (!line.empty())
+        {
+            words.push_back(line);
+        }
+    }
+    return words;
+}
+
+// the bundled words cut or wrapped to Length letters, so every word length
+// is checked against real spellings. wrapping repeats leading letters,
+// which gives the longer lengths plenty of duplicate letters.
+template <std::size_t Length>
+static std::vector<Word<Length> > wordsAtLength(const std::vector<std::string> &words)
+{
+    std::set<std::string> seen;
+    std::vector<Word<Length> > result;
+    for (const auto &word : words)
+    {
+        std::string resized;
+        while (resized.size() < Length)
+        {
+            resized += word.substr(0, Length - resized.size());
+        }
+        if (seen.insert(resized).second)
+        {
+            result.push_back(Word<Length>(resized));
+        }
+    }
+    return result;
+}
+
+// the guesses checked: every answer, then every CHECK_GUESS_STRIDE'th guess.
+template <std::size_t Length>
+static std::vector<Word<Length> > checkedGuesses(const CheckLists &lists)
+{
+    std::vector<std::string> words = lists.answers;
+    for (std::size_t i = 0; i < lists.guesses.size(); i += CHECK_GUESS_STRIDE)
+    {
+        words.push_back(lists.guesses[i]);
+    }
+    return wordsAtLength<Length>(words);
+}
+
+// every kernel the cpu supports gives every answer computeFeedbackId's id.
+template <std::size_t Length>
+static bool checkFeedbackKernels(const CheckLists &lists)
+{
+    std::vector<Word<Length> > answers = wordsAtLength<Length>(lists.answers);
+    std::vector<Word<Length> > guesses = checkedGuesses<Length>(lists);
+    PackedAnswers<Length> packed;
+    packed.assign(answers);
+    std::vector<FeedbackCell<Length> > feedbackIds(packed.paddedSize());
+    for (const auto &kernel : availableFeedbackKernels<Length>())
+    {
+        for (const auto &guess : guesses)
+        {
+            uint8_t guessCodes[Length];
+            for (std::size_t p = 0; p < Length; p++)
+            {
+                guessCodes[p] = guess.letterCode(p);
+            }
+            kernel.kernel(guessCodes, packed, feedbackIds.data());
+            for (std::size_t i = 0; i < answers.size(); i++)
+            {
+                int32_t expected = WordleGame<Length>::computeFeedbackId(guess, answers[i]);
+                if (feedbackIds[i] != expected)
+                {
+                    std::cout << kernel.name << " kernel: " << guess << " against " << answers[i] << " gave "
+                              << static_cast<int32_t>(feedbackIds[i]) << ", expected " << expected << std::endl;
+                    return false;
+                }
+            }
+        }
+        std::cout << kernel.name << " kernel agrees at length " << Length << " over " << guesses.size()
+                  << " guesses and " << answers.size() << " answers" << std::endl;
+    }
+    return true;
+}
+
+static bool hasRepeatedLetter(const std::string &word)
+{
+    return std::set<char>(word.begin(), word.end()).size() < word.size();
+}
+
+// FeedbackConstraints built from one feedback allows exactly the words
+// GuessFeedback::isConsistentWith does. the repeated letters are where the
+// copy counts come in, and every feedback id is tried, including the ones
+// no answer gives, which must allow nothing.
+template <std::size_t Length>
+static bool checkFeedbackConstraints(const CheckLists &lists)
+{
+    std::vector<Word<Length> > answers = wordsAtLength<Length>(lists.answers);
+    std::vector<Word<Length> > guesses;
+    for (const auto &guess : checkedGuesses<Length>(lists))
+    {
+        if (guesses.size() < CHECK_REPEATED_LETTER_GUESSES && hasRepeatedLetter(guess.toString()))
+        {
+            guesses.push_back(guess);
+        }
+    }
+    for (const auto &guess : guesses)
+    {
+        for (int32_t feedbackId = 0; feedbackId <= maxFeedbackId(Length); feedbackId++)
+        {
+            GuessFeedback<Length> guessFeedback(guess, feedbackId);
+            FeedbackConstraints<Length> constraints(guessFeedback);
+            for (const auto &answer : answers)
+            {
+                bool expected = guessFeedback.isConsistentWith(answer);
+                if (constraints.allows(answer) != expected)
+                {
+                    std::cout << "feedback constraints: " << guess << " with feedback " << feedbackId
+                              << (expected ? " rejected " : " allowed ") << answer << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    std::cout << "feedback constraints agree at length " << Length << " over " << guesses.size()
+              << " guesses with repeated letters" << std::endl;
+    return true;
+}
+
+template <std::size_t Length>
+static bool checkLength(const CheckLists &lists)
+{
+    bool kernelsPassed = checkFeedbackKernels<Length>(lists);
+    return checkFeedbackConstraints<Length>(lists) && kernelsPassed;
+}
+
+int main()
+{
+    CheckLists lists;
+    lists.answers = readWordStrings("answers.txt");
+    lists.guesses = readWordStrings("guesses.txt");
+    bool passed = true;
+#define CHECK_LENGTH(Length) passed = checkLength<Length>(lists) && passed;
+    WORDLE_FOR_EACH_WORD_LENGTH(CHECK_LENGTH)
+#undef CHECK_LENGTH
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
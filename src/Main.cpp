@@ -1,392 +1,719 @@
-#include <iostream>
-#include <string>
-#include <vector>
-#include <memory>
+#include "wordle/CacheFile.h"
+#include "wordle/DecisionTree.h"
+#include "wordle/Profile.h"
+#include "wordle/Regression.h"
+#include "wordle/Server.h"
+#include "wordle/Solver.h"
+#include "wordle/TranspositionCache.h"
+#include "wordle/WordList.h"
+#include "wordle/WordleGame.h"
+#include "wordle/WorkerPool.h"
+
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
-#include <bitset>
-#include <array>
+#include <iomanip>
+#include <iostream>
 #include <sstream>
-
-#define NUMBER_OF_LETTERS 26
-#define WORD_LENGTH 5
-#define MAX_GUESSES 10
-
-#define FEEDBACK_NOT_IN_WORD 0
-#define FEEDBACK_IN_WORD 1
-#define FEEDBACK_IN_POSITION 2
-#define MAX_FEEDBACK_ID (             \
-    (FEEDBACK_IN_POSITION << 0 * 2) | \
-    (FEEDBACK_IN_POSITION << 1 * 2) | \
-    (FEEDBACK_IN_POSITION << 2 * 2) | \
-    (FEEDBACK_IN_POSITION << 3 * 2) | \
-    (FEEDBACK_IN_POSITION << 4 * 2))
-typedef uint8_t Feedback;
-typedef char Letter;
-
-ssize_t indexForLetter(Letter letter)
+#include <stdexcept>
+#include <thread>
+
+// solves every answer in its own game and prints the guess count
+// distribution and timings. with batchSize above 1 the games are played
+// batchSize at a time in lockstep, each turn scored in one pass on pool;
+// otherwise games run in parallel on pool.
+template <std::size_t Length>
+void runBenchmarkAll(
+    const WordleGame<Length> &prototype,
+    WorkerPool &pool,
+    const TranspositionCache *transpositionCache,
+    std::size_t batchSize)
 {
-    if (!('a' <= letter && letter <= 'z'))
+    auto answerWords = prototype.getAnswerWords();
+    std::vector<SolveResult> results(answerWords->size());
+    auto start = std::chrono::steady_clock::now();
+    if (batchSize > 1)
     {
-        std::cerr << "Invalid letter " << std::hex << static_cast<int>(letter) << std::endl;
-        throw std::runtime_error("Invalid letter");
+        for (std::size_t begin = 0; begin < answerWords->size(); begin += batchSize)
+        {
+            std::size_t end = std::min(begin + batchSize, answerWords->size());
+            std::vector<std::unique_ptr<WordleGame<Length> > > ownedGames;
+            std::vector<WordleGame<Length> *> games;
+            for (std::size_t answerIndex = begin; answerIndex < end; answerIndex++)
+            {
+                ownedGames.push_back(prototype.newGame());
+                games.push_back(ownedGames.back().get());
+            }
+            std::vector<Word<Length> > solutions(answerWords->begin() + begin, answerWords->begin() + end);
+            std::vector<SolveResult> batchResults = solveGames(games, solutions, &pool);
+            std::copy(batchResults.begin(), batchResults.end(), results.begin() + begin);
+        }
     }
-    return static_cast<ssize_t>(letter - 'a');
-}
-
-class Word
-{
-public:
-    Word(std::string wordString);
-    ~Word();
-    bool containsLetter(const Letter letter);
-    const Letter &operator[](std::size_t index) const;
-    std::string toString() const;
-    friend std::ostream &operator<<(std::ostream &stream, const Word &word);
-
-private:
-    std::array<Letter, WORD_LENGTH> letters;
-    std::array<std::bitset<WORD_LENGTH>, NUMBER_OF_LETTERS> letterPositionMap;
-};
-
-Word::Word(std::string wordString)
-{
-    if (wordString.size() != WORD_LENGTH)
+    else
     {
-        throw std::runtime_error("Invalid word length");
+        pool.parallelFor(
+            answerWords->size(), 1,
+            [&](std::size_t, std::size_t begin, std::size_t end)
+            {
+                for (std::size_t answerIndex = begin; answerIndex < end; answerIndex++)
+                {
+                    auto game = prototype.newGame();
+                    results[answerIndex] = solveGame(*game, (*answerWords)[answerIndex], NULL);
+                }
+            });
     }
-    for (int32_t i = 0; i < WORD_LENGTH; i++)
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<int32_t> guessCounts(MAX_GUESSES + 1, 0);
+    int32_t numSolved = 0;
+    int32_t numFailures = 0;
+    int64_t totalGuesses = 0;
+    double solveSeconds = 0;
+    double slowestSolveSeconds = 0;
+    for (std::size_t answerIndex = 0; answerIndex < results.size(); answerIndex++)
     {
-        char letter = wordString[i];
-        letters[i] = letter;
-        letterPositionMap[indexForLetter(letter)][i] = true;
+        const SolveResult &result = results[answerIndex];
+        solveSeconds += result.seconds;
+        slowestSolveSeconds = std::max(slowestSolveSeconds, result.seconds);
+        if (!result.solved || result.numGuesses > WORDLE_TURN_LIMIT)
+        {
+            numFailures++;
+            std::cout << "failed: " << (*answerWords)[answerIndex] << std::endl;
+        }
+        if (result.solved)
+        {
+            numSolved++;
+            totalGuesses += result.numGuesses;
+            guessCounts[result.numGuesses]++;
+        }
     }
-}
 
-Word::~Word()
-{
+    std::cout << "games: " << results.size() << std::endl;
+    for (int32_t numGuesses = 1; numGuesses <= MAX_GUESSES; numGuesses++)
+    {
+        if (guessCounts[numGuesses] > 0)
+        {
+            std::cout << numGuesses << " guesses: " << guessCounts[numGuesses] << std::endl;
+        }
+    }
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "mean guesses: " << (numSolved > 0 ? static_cast<double>(totalGuesses) / numSolved : 0) << std::endl;
+    std::cout << "failures: " << numFailures << std::endl;
+    std::cout << "mean seconds per solve: " << solveSeconds / std::max<std::size_t>(results.size(), 1) << std::endl;
+    std::cout << "slowest solve seconds: " << slowestSolveSeconds << std::endl;
+    std::cout << "wall seconds: " << totalSeconds << std::endl;
+    if (transpositionCache)
+    {
+        std::cout << "transposition cache hits: " << transpositionCache->numHits()
+                  << " misses: " << transpositionCache->numMisses() << std::endl;
+    }
+    if (prototype.getFeedbackBlocks())
+    {
+        std::cout << "matrix block hits: " << prototype.getFeedbackBlocks()->numHits()
+                  << " misses: " << prototype.getFeedbackBlocks()->numMisses() << std::endl;
+    }
 }
 
-std::string Word::toString() const
+template <std::size_t Length>
+void saveTranspositionCache(
+    const TranspositionCache *transpositionCache,
+    const std::string &path,
+    uint64_t sourceChecksum,
+    const WordleGame<Length> &game)
 {
-    std::stringstream result;
-    for (int32_t i = 0; i < WORD_LENGTH; i++)
+    if (!transpositionCache || path.empty())
+    {
+        return;
+    }
+    try
     {
-        result << letters[i];
+        transpositionCache->save(path, sourceChecksum, Length, game.getGuessWords()->size());
+    }
+    catch (const std::runtime_error &error)
+    {
+        std::cerr << error.what() << std::endl;
     }
-    return result.str();
 }
 
-bool Word::containsLetter(Letter letter)
-{
-    return letterPositionMap[indexForLetter(letter)].any();
-}
+#ifdef WORDLE_PROFILE
 
-const Letter &Word::operator[](std::size_t index) const
+void writeProfileAtExit()
 {
-    return letters[index];
+    Profile::writeJson(std::cerr);
+    std::cerr << std::endl;
 }
 
-std::ostream &operator<<(std::ostream &stream, const Word &word)
+#endif
+
+// command line settings, the same for every word length.
+struct SolverOptions
 {
-    return stream << word.toString();
-}
+    bool useFeedbackMatrix;
+    std::size_t matrixMemoryBytes;
+    std::string cachePath;
+    std::string buildCachePath;
+    int32_t numThreads;
+    std::string strategyName;
+    int32_t searchDepth;
+    int32_t searchBreadth;
+    std::size_t guessPrefilterSize;
+    bool hardMode;
+    bool benchmarkAll;
+    std::size_t batchSize;
+    std::string buildTreePath;
+    std::string treePath;
+    std::size_t openingBookTurns;
+    std::size_t transpositionCacheSize;
+    std::string transpositionCachePath;
+    std::string serveAddress;
+    int32_t deadlineMilliseconds;
+    std::string regressionPath;
+    std::string baselinePath;
+    double regressionThreshold;
+
+    SolverOptions() : useFeedbackMatrix(false),
+                      matrixMemoryBytes(0),
+                      numThreads(1),
+                      strategyName("expected"),
+                      searchDepth(1),
+                      searchBreadth(16),
+                      guessPrefilterSize(0),
+                      hardMode(false),
+                      benchmarkAll(false),
+                      batchSize(1),
+                      openingBookTurns(0),
+                      transpositionCacheSize(1 << 16),
+                      deadlineMilliseconds(0),
+                      regressionThreshold(0.1)
+    {
+    }
+};
 
-struct GuessFeedback
+// solves every answer with each scoring strategy at each search depth up to
+// --depth, the rest of the settings as in prototype, and writes the results
+// to options.regressionPath. returns 1 when they regress against
+// options.baselinePath.
+template <std::size_t Length>
+int runRegressionSuite(const WordleGame<Length> &prototype, WorkerPool &pool, const SolverOptions &options)
 {
-    char guess[WORD_LENGTH];
-    Feedback feedback[WORD_LENGTH];
-    GuessFeedback(Word guessString, int32_t feedbackId)
+    std::vector<RegressionResult> results;
+    for (const auto &strategyName : scoringStrategyNames())
     {
-        for (int32_t i = 0; i < WORD_LENGTH; i++)
+        for (int32_t depth = 1; depth <= options.searchDepth; depth++)
         {
-            guess[i] = guessString[i];
-            feedback[i] = (feedbackId >> (2 * i)) & 0x3;
+            auto game = prototype.newGame();
+            game->setScoringStrategy(createScoringStrategy(strategyName, game->numAnswers()));
+            game->setSearchDepth(depth, options.searchBreadth);
+            // a tree or book is only good for the settings it was built with.
+            game->setDecisionTree(std::shared_ptr<const DecisionTree<Length> >());
+            // each configuration starts cold, so its timings don't depend on
+            // the ones before it.
+            if (options.transpositionCacheSize > 0)
+            {
+                game->setTranspositionCache(std::make_shared<TranspositionCache>(options.transpositionCacheSize));
+            }
+            RegressionResult result = runRegression(*game, pool);
+            std::cout << std::fixed << std::setprecision(4) << result.configuration
+                      << ": mean guesses " << result.meanGuesses
+                      << ", worst " << result.worstGuesses
+                      << ", failures " << result.numFailures
+                      << ", p50/p99 turn ms " << result.p50TurnSeconds * 1e3 << " / " << result.p99TurnSeconds * 1e3
+                      << ", games per second " << result.gamesPerSecond
+                      << ", cpu seconds " << result.cpuSeconds
+                      << ", peak rss MiB " << (result.peakRssBytes >> 20) << std::endl;
+            results.push_back(result);
         }
     }
-    GuessFeedback(std::string guessString, std::string feedbackString)
+    std::ofstream output(options.regressionPath);
+    writeRegressionJson(output, Length, results);
+    output.close();
+    if (!output)
     {
-        if (guessString.size() != WORD_LENGTH)
-        {
-            throw std::runtime_error("Invalid guess length");
-        }
-        if (feedbackString.size() != WORD_LENGTH)
+        std::cerr << "Unable to write " << options.regressionPath << std::endl;
+        return 1;
+    }
+    if (options.baselinePath.empty())
+    {
+        return 0;
+    }
+    std::ifstream baselineFile(options.baselinePath);
+    if (!baselineFile.is_open())
+    {
+        std::cerr << "Unable to read baseline " << options.baselinePath << std::endl;
+        return 1;
+    }
+    std::vector<std::string> regressions;
+    try
+    {
+        regressions = findRegressions(readRegressionJson(baselineFile), results, options.regressionThreshold);
+    }
+    catch (const std::runtime_error &error)
+    {
+        std::cerr << options.baselinePath << ": " << error.what() << std::endl;
+        return 1;
+    }
+    for (const auto &regression : regressions)
+    {
+        std::cout << "regression: " << regression << std::endl;
+    }
+    return regressions.empty() ? 0 : 1;
+}
+
+// everything after the command line, for Length-letter word lists.
+template <std::size_t Length>
+int runSolver(const SolverOptions &options, const std::string &answersText, const std::string &guessesText)
+{
+    uint64_t sourceChecksum = checksumBytes(guessesText, checksumBytes(answersText));
+    CachedDictionary<Length> cached;
+    bool loadedCache = false;
+    if (!options.cachePath.empty())
+    {
+        try
         {
-            throw std::runtime_error("Invalid feedback length");
+            loadedCache = loadCacheFile(options.cachePath, sourceChecksum, cached);
         }
-
-        for (int32_t i = 0; i < WORD_LENGTH; i++)
+        catch (const std::runtime_error &error)
         {
-            guess[i] = guessString[i];
-            switch (feedbackString[i])
-            {
-            case 'r':
-                feedback[i] = FEEDBACK_NOT_IN_WORD;
-                break;
-            case 'y':
-                feedback[i] = FEEDBACK_IN_WORD;
-                break;
-            case 'g':
-                feedback[i] = FEEDBACK_IN_POSITION;
-                break;
-            default:
-                throw std::runtime_error("Invalid feedback code");
-                break;
-            }
+            std::cerr << "Ignoring cache file: " << error.what() << std::endl;
         }
     }
+    std::unique_ptr<std::vector<Word<Length> > > answerWords;
+    std::unique_ptr<std::vector<Word<Length> > > guessWords;
+    if (loadedCache)
+    {
+        answerWords = std::move(cached.answerWords);
+        guessWords = std::move(cached.guessWords);
+    }
+    else
+    {
+        std::istringstream answersStream(answersText);
+        answerWords = readFileLines<Length>(answersStream);
+        std::istringstream guessesStream(guessesText);
+        guessWords = readFileLines<Length>(guessesStream);
+    }
+    // the cache stores the lists as read, before the game adds the answers
+    // to its guesses.
+    std::vector<Word<Length> > sourceAnswerWords;
+    std::vector<Word<Length> > sourceGuessWords;
+    if (!options.buildCachePath.empty() || !options.cachePath.empty())
+    {
+        sourceAnswerWords = *answerWords;
+        sourceGuessWords = *guessWords;
+    }
 
-    bool isConsistentWith(Word word)
+    WordleGame<Length> game(std::move(guessWords), std::move(answerWords));
+    bool rewriteCache = false;
+    if (!options.buildCachePath.empty())
     {
-        for (int32_t i = 0; i < WORD_LENGTH; i++)
+        WorkerPool pool(options.numThreads);
+        auto start = std::chrono::steady_clock::now();
+        try
         {
-            switch (feedback[i])
-            {
-            case FEEDBACK_NOT_IN_WORD:
-                if (word.containsLetter(guess[i]))
-                {
-                    return false;
-                }
-                break;
-            case FEEDBACK_IN_WORD:
-                if (!word.containsLetter(guess[i]))
-                {
-                    return false;
-                }
-                if (word[i] == guess[i])
+            buildCacheFile(
+                options.buildCachePath, sourceChecksum, sourceAnswerWords, sourceGuessWords,
+                *game.getGuessWords(), *game.getAnswerWords(), pool,
+                [](std::size_t rowsDone, std::size_t numRows)
                 {
-                    return false;
-                }
-                break;
-            case FEEDBACK_IN_POSITION:
-                if (word[i] != guess[i])
-                {
-                    return false;
-                }
-                break;
-            }
+                    std::cerr << "\rmatrix rows: " << rowsDone << " / " << numRows << std::flush;
+                });
+        }
+        catch (const std::runtime_error &error)
+        {
+            std::cerr << std::endl
+                      << error.what() << std::endl;
+            exit(1);
         }
-        return true;
+        std::cerr << std::endl;
+        std::cout << "cache matrix: " << game.getGuessWords()->size() << " x " << game.getAnswerWords()->size()
+                  << " in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+                  << " seconds" << std::endl;
+        return 0;
     }
-};
-
-class WordleGame
-{
-
-public:
-    WordleGame(
-        std::unique_ptr<std::vector<Word> > guessWords,
-        std::unique_ptr<std::vector<Word> > answerWords);
-    ~WordleGame();
-
-    bool isPossibleAnswer(Word word);
-    Word getGuess();
-    void pushFeedback(GuessFeedback guessFeedback);
-    void popFeedback();
-    static GuessFeedback computeFeedback(Word guess, Word solution);
-    static int32_t computeFeedbackId(Word guess, Word solution);
-
-private:
-    const std::unique_ptr<std::vector<Word> > guessWords;
-    const std::unique_ptr<std::vector<Word> > answerWords;
-    std::vector<GuessFeedback> feedbacks;
-};
-
-WordleGame::WordleGame(
-    std::unique_ptr<std::vector<Word> > guessWordList,
-    std::unique_ptr<std::vector<Word> > answerWordList) : guessWords(std::move(guessWordList)),
-                                                          answerWords(std::move(answerWordList))
-{
-    guessWords->insert(guessWords->end(), answerWords->begin(), answerWords->end());
-    feedbacks.reserve(MAX_GUESSES);
-}
-
-WordleGame::~WordleGame()
-{
-}
-
-int32_t WordleGame::computeFeedbackId(Word guess, Word solution)
-{
-    int32_t result = 0;
-    for (int32_t i = 0; i < WORD_LENGTH; i++)
+    if (cached.feedbackMatrix)
     {
-        Feedback code;
-        if (solution[i] == guess[i])
+        try
         {
-            code = FEEDBACK_IN_POSITION;
+            game.setFeedbackMatrix(cached.feedbackMatrix);
         }
-        else if (solution.containsLetter(guess[i]))
+        catch (const std::runtime_error &error)
         {
-            code = FEEDBACK_IN_WORD;
+            // built again below, as if the cache held none.
+            std::cerr << "Ignoring cache matrix: " << error.what() << std::endl;
+            cached.feedbackMatrix.reset();
+        }
+    }
+    if (!cached.feedbackMatrix && options.useFeedbackMatrix)
+    {
+        std::size_t matrixBytes = game.getGuessWords()->size() * game.getAnswerWords()->size() * sizeof(FeedbackCell<Length>);
+        if (options.matrixMemoryBytes > 0 && matrixBytes > options.matrixMemoryBytes)
+        {
+            // too big to keep, so not worth writing to the cache either.
+            game.enableFeedbackBlocks(options.matrixMemoryBytes);
         }
         else
         {
-            code = FEEDBACK_NOT_IN_WORD;
+            game.enableFeedbackMatrix();
+            rewriteCache = !options.cachePath.empty();
         }
-        result |= code << (2 * i);
     }
-    return result;
-}
-
-GuessFeedback WordleGame::computeFeedback(Word guess, Word solution)
-{
-    return GuessFeedback(guess, computeFeedbackId(guess, solution));
-}
-
-Word WordleGame::getGuess()
-{
-    if (feedbacks.size() == 0)
+    auto scoringStrategy = createScoringStrategy(options.strategyName, game.numAnswers());
+    if (!scoringStrategy)
     {
-        // pre-computed known best first guess.
-        return Word("roate");
+        std::cerr << "Unknown strategy " << options.strategyName << std::endl;
+        exit(1);
     }
-    int32_t leastPossibleSolutions = -1;
-    Word bestGuess = (*guessWords)[0];
-    std::vector<int32_t> feedbackIdCounts;
-
-    int32_t numPossibleSolutions = 0;
-    for (auto possibleSolution : *answerWords)
+    game.setScoringStrategy(scoringStrategy);
+    game.setSearchDepth(options.searchDepth, options.searchBreadth);
+    game.setGuessPrefilter(options.guessPrefilterSize);
+    game.setHardMode(options.hardMode);
+    auto workerPool = std::make_shared<WorkerPool>(options.numThreads);
+    std::shared_ptr<TranspositionCache> transpositionCache;
+    if (options.transpositionCacheSize > 0)
     {
-        if (isPossibleAnswer(possibleSolution))
+        transpositionCache = std::make_shared<TranspositionCache>(options.transpositionCacheSize);
+        if (!options.transpositionCachePath.empty())
         {
-            numPossibleSolutions++;
+            transpositionCache->load(options.transpositionCachePath, sourceChecksum, Length, game.getGuessWords()->size());
         }
+        game.setTranspositionCache(transpositionCache);
     }
-    if (numPossibleSolutions < 100)
+    // the book is only good for the settings it was built with, so any
+    // change to them builds it again.
+    OpeningBook<Length> openingBook = cached.openingBook;
+    if (options.openingBookTurns > 0)
     {
-        std::cout << "POSSIBLE SOLUTIONS: " << std::endl;
-        for (auto possibleSolution : *answerWords)
+        std::string bookConfiguration = game.configurationName() + "/book" + std::to_string(options.openingBookTurns);
+        if (!openingBook.tree || openingBook.configuration != bookConfiguration ||
+            openingBook.guessCount != game.getGuessWords()->size())
         {
-            if (isPossibleAnswer(possibleSolution))
-            {
-                std::cout << possibleSolution << std::endl;
-            }
+            openingBook.tree = buildDecisionTree(game, *workerPool, options.openingBookTurns);
+            openingBook.configuration = bookConfiguration;
+            openingBook.guessCount = game.getGuessWords()->size();
+            rewriteCache = !options.cachePath.empty();
+            std::cerr << "opening book nodes: " << openingBook.tree->numNodes() << std::endl;
         }
+        game.setDecisionTree(openingBook.tree);
     }
-    if (numPossibleSolutions <= 2)
+    if (rewriteCache)
     {
-        for (auto possibleSolution : *answerWords)
+        try
         {
-            if (isPossibleAnswer(possibleSolution))
-            {
-                return possibleSolution;
-            }
+            writeCacheFile(
+                options.cachePath, sourceChecksum, sourceAnswerWords, sourceGuessWords, game.getFeedbackMatrix().get(),
+                openingBook.tree ? &openingBook : NULL);
+        }
+        catch (const std::runtime_error &error)
+        {
+            std::cerr << error.what() << std::endl;
         }
     }
-
-    for (auto potentialGuess : *guessWords)
+    if (!options.buildTreePath.empty())
     {
-        feedbackIdCounts.clear();
-        feedbackIdCounts.resize(MAX_FEEDBACK_ID + 1, 0);
-        int32_t numberRemainingPossibleSolutions = 0;
-
-        for (auto presumedSolution : *answerWords)
+        auto tree = buildDecisionTree(game, *workerPool, MAX_GUESSES);
+        try
         {
-            if (!isPossibleAnswer(presumedSolution))
-                continue;
-            auto feedbackId = computeFeedbackId(potentialGuess, presumedSolution);
-            feedbackIdCounts[feedbackId]++;
+            tree->save(options.buildTreePath, sourceChecksum, game.configurationName(), game.getGuessWords()->size());
         }
-        for (int32_t feedbackId = 0; feedbackId <= MAX_FEEDBACK_ID; feedbackId++)
+        catch (const std::runtime_error &error)
         {
-            if (feedbackIdCounts[feedbackId] == 0)
-                continue;
-            pushFeedback(GuessFeedback(potentialGuess, feedbackId));
-            for (auto possibleSolution : *answerWords)
+            std::cerr << error.what() << std::endl;
+            exit(1);
+        }
+        std::cout << "decision tree nodes: " << tree->numNodes() << std::endl;
+        return 0;
+    }
+    if (!options.treePath.empty())
+    {
+        std::shared_ptr<const DecisionTree<Length> > tree;
+        try
+        {
+            tree = DecisionTree<Length>::load(options.treePath, sourceChecksum, game.configurationName(), game.getGuessWords()->size());
+            if (!tree)
             {
-                if (isPossibleAnswer(possibleSolution))
-                {
-                    numberRemainingPossibleSolutions += feedbackIdCounts[feedbackId];
-                }
+                std::cerr << "Decision tree " << options.treePath << " does not match these word lists and settings" << std::endl;
             }
-            popFeedback();
         }
-
-        if (numberRemainingPossibleSolutions < leastPossibleSolutions || leastPossibleSolutions < 0)
+        catch (const std::runtime_error &error)
+        {
+            // searched instead, like a mismatched tree.
+            std::cerr << "Ignoring decision tree: " << error.what() << std::endl;
+        }
+        if (tree)
         {
-            leastPossibleSolutions = numberRemainingPossibleSolutions;
-            bestGuess = potentialGuess;
+            game.setDecisionTree(tree);
         }
     }
-    return bestGuess;
-}
-
-void WordleGame::pushFeedback(GuessFeedback guessFeedback)
-{
-    feedbacks.push_back(guessFeedback);
-}
-
-void WordleGame::popFeedback()
-{
-    feedbacks.pop_back();
-}
-
-bool WordleGame::isPossibleAnswer(Word word)
-{
-    for (auto guessFeedback : feedbacks)
+    if (!options.regressionPath.empty())
+    {
+        return runRegressionSuite(game, *workerPool, options);
+    }
+    if (options.benchmarkAll)
     {
-        if (!guessFeedback.isConsistentWith(word))
+        // games run in parallel instead, each scoring on its own thread.
+        runBenchmarkAll(game, *workerPool, transpositionCache.get(), options.batchSize);
+        saveTranspositionCache(transpositionCache.get(), options.transpositionCachePath, sourceChecksum, game);
+        return 0;
+    }
+    if (!options.serveAddress.empty())
+    {
+#ifdef WORDLE_SERVER
+        try
+        {
+            // sessions search on the server's own threads instead.
+            workerPool.reset();
+            SolverServer<Length> server(game, options.numThreads);
+            server.setSearchDeadline(std::chrono::milliseconds(options.deadlineMilliseconds));
+            server.listen(options.serveAddress);
+            std::cerr << "serving on " << options.serveAddress << std::endl;
+            server.run();
+        }
+        catch (const std::runtime_error &error)
         {
-            return false;
+            std::cerr << error.what() << std::endl;
+            exit(1);
         }
+        saveTranspositionCache(transpositionCache.get(), options.transpositionCachePath, sourceChecksum, game);
+        return 0;
+#else
+        std::cerr << "Server mode needs epoll" << std::endl;
+        exit(1);
+#endif
+    }
+    if (options.numThreads > 1)
+    {
+        game.setWorkerPool(workerPool);
     }
-    return true;
-}
-
-std::unique_ptr<std::vector<Word> > readFileLines(std::istream &stream)
-{
-    std::unique_ptr<std::vector<Word> > lines(new std::vector<Word>);
-
     std::string line;
-    while (std::getline(stream, line))
+    while (true)
     {
-        lines->push_back(Word(line));
+        if (game.numFeedbacks() > 0)
+        {
+            auto possibleAnswers = game.getPossibleAnswers();
+            if (possibleAnswers.size() < 100)
+            {
+                std::cout << "POSSIBLE SOLUTIONS: " << std::endl;
+                for (const auto &possibleAnswer : possibleAnswers)
+                {
+                    std::cout << possibleAnswer << std::endl;
+                }
+            }
+        }
+        Word<Length> guess = game.getGuess();
+        std::cout << "guess: " << guess << std::endl;
+        bool gotFeedback = false;
+        do
+        {
+            std::cout << "feedback: " << std::flush;
+
+            if (!std::getline(std::cin, line))
+            {
+                std::cout << std::endl;
+                saveTranspositionCache(transpositionCache.get(), options.transpositionCachePath, sourceChecksum, game);
+                return 0;
+            }
+            try
+            {
+                game.pushFeedback(GuessFeedback<Length>(guess.toString(), line));
+                gotFeedback = true;
+            }
+            catch (const std::runtime_error &)
+            {
+                std::cout << "Invalid feedback!" << std::endl;
+            }
+        } while (!gotFeedback);
     }
 
-    return lines;
+    return 0;
 }
 
 int main(int argc, char **argv)
 {
+#ifdef WORDLE_PROFILE
+    std::atexit(writeProfileAtExit);
+#endif
     std::ifstream answersFile("answers.txt");
     if (!answersFile.is_open())
     {
         std::cerr << "Unable to read answers file" << std::endl;
         exit(1);
     }
-    auto answerWords = readFileLines(answersFile);
+    std::string answersText = readFileBytes(answersFile);
     std::ifstream guessesFile("guesses.txt");
     if (!guessesFile.is_open())
     {
         std::cerr << "Unable to read guesses file" << std::endl;
         exit(1);
     }
-    auto guessWords = readFileLines(guessesFile);
+    std::string guessesText = readFileBytes(guessesFile);
 
-    WordleGame game(std::move(guessWords), std::move(answerWords));
-    std::string line;
-    while (true)
+    SolverOptions options;
+    for (int32_t i = 1; i < argc; i++)
     {
-        Word guess = game.getGuess();
-        std::cout << "guess: " << guess << std::endl;
-        bool gotFeedback = false;
-        do
+        std::string arg = argv[i];
+        if (arg == "--matrix")
         {
-            std::cout << "feedback: " << std::flush;
-
-            if (std::getline(std::cin, line))
+            options.useFeedbackMatrix = true;
+        }
+        else if (arg == "--matrix-memory-mb" && i + 1 < argc)
+        {
+            // the most the matrix may take. a bigger one is computed in row
+            // blocks as needed, keeping as many blocks as fit.
+            options.useFeedbackMatrix = true;
+            options.matrixMemoryBytes = std::strtoul(argv[++i], NULL, 10) << 20;
+            if (options.matrixMemoryBytes == 0)
             {
-                try
-                {
-                    game.pushFeedback(GuessFeedback(guess.toString(), line));
-                    gotFeedback = true;
-                }
-                catch (const std::runtime_error &)
-                {
-                    std::cout << "Invalid feedback!" << std::endl;
-                }
+                std::cerr << "Invalid matrix memory limit" << std::endl;
+                exit(1);
             }
-        } while (!gotFeedback);
+        }
+        else if (arg == "--benchmark-all")
+        {
+            options.benchmarkAll = true;
+        }
+        else if (arg == "--batch" && i + 1 < argc)
+        {
+            // --benchmark-all games played in lockstep per scoring pass.
+            options.batchSize = std::strtoul(argv[++i], NULL, 10);
+        }
+        else if (arg == "--regression" && i + 1 < argc)
+        {
+            // --benchmark-all for every strategy and depth up to --depth,
+            // written as json to this file.
+            options.regressionPath = argv[++i];
+        }
+        else if (arg == "--baseline" && i + 1 < argc)
+        {
+            // an earlier --regression file; exit 1 if this run is worse.
+            options.baselinePath = argv[++i];
+        }
+        else if (arg == "--regression-threshold" && i + 1 < argc)
+        {
+            // how much slower than the baseline still passes, a fraction.
+            options.regressionThreshold = std::atof(argv[++i]);
+            if (options.regressionThreshold < 0)
+            {
+                std::cerr << "Invalid regression threshold" << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--build-tree" && i + 1 < argc)
+        {
+            options.buildTreePath = argv[++i];
+        }
+        else if (arg == "--tree" && i + 1 < argc)
+        {
+            options.treePath = argv[++i];
+        }
+        else if (arg == "--opening-book" && i + 1 < argc)
+        {
+            // look up the guesses of the first this many turns in a table
+            // built once and kept in the --cache file.
+            options.openingBookTurns = std::strtoul(argv[++i], NULL, 10);
+        }
+        else if (arg == "--transposition-cache-size" && i + 1 < argc)
+        {
+            // entries; 0 turns the cache off.
+            options.transpositionCacheSize = std::strtoul(argv[++i], NULL, 10);
+        }
+        else if (arg == "--transposition-cache-file" && i + 1 < argc)
+        {
+            // loaded at startup and written back at exit.
+            options.transpositionCachePath = argv[++i];
+        }
+        else if (arg == "--cache" && i + 1 < argc)
+        {
+            // load the word lists and matrix from this file, rebuilding it
+            // when the word lists have changed.
+            options.cachePath = argv[++i];
+            options.useFeedbackMatrix = true;
+        }
+        else if (arg == "--build-cache" && i + 1 < argc)
+        {
+            // write a cache file with the matrix, built on --threads
+            // threads, and exit.
+            options.buildCachePath = argv[++i];
+        }
+        else if (arg == "--serve" && i + 1 < argc)
+        {
+            // unix:<path> or tcp:[<host>:]<port>.
+            options.serveAddress = argv[++i];
+        }
+        else if (arg == "--deadline-ms" && i + 1 < argc)
+        {
+            // longest a server GUESS may search before it answers with the
+            // best guess so far.
+            options.deadlineMilliseconds = std::atoi(argv[++i]);
+            if (options.deadlineMilliseconds < 0)
+            {
+                std::cerr << "Invalid deadline" << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--strategy" && i + 1 < argc)
+        {
+            options.strategyName = argv[++i];
+        }
+        else if (arg == "--depth" && i + 1 < argc)
+        {
+            // turns to look ahead; 1 is the plain strategy score.
+            options.searchDepth = std::atoi(argv[++i]);
+            if (options.searchDepth < 1)
+            {
+                std::cerr << "Invalid search depth" << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--search-breadth" && i + 1 < argc)
+        {
+            // guesses tried per turn when looking ahead.
+            options.searchBreadth = std::atoi(argv[++i]);
+            if (options.searchBreadth < 1)
+            {
+                std::cerr << "Invalid search breadth" << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--top-k" && i + 1 < argc)
+        {
+            // guesses scored exactly per turn; 0 scores them all.
+            options.guessPrefilterSize = std::strtoul(argv[++i], NULL, 10);
+        }
+        else if (arg == "--hard")
+        {
+            // every guess must use the hints revealed so far.
+            options.hardMode = true;
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            // 0 means one thread per core.
+            options.numThreads = std::atoi(argv[++i]);
+            if (options.numThreads == 0)
+            {
+                options.numThreads = static_cast<int32_t>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+            if (options.numThreads < 0)
+            {
+                std::cerr << "Invalid thread count" << std::endl;
+                exit(1);
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            exit(1);
+        }
     }
 
-    return 0;
-}
\ No newline at end of file
+    // one instantiation per word length; the answers pick which one runs.
+    switch (firstWordLength(answersText))
+    {
+#define RUN_SOLVER(Length) \
+    case Length:           \
+        return runSolver<Length>(options, answersText, guessesText);
+        WORDLE_FOR_EACH_WORD_LENGTH(RUN_SOLVER)
+#undef RUN_SOLVER
+    default:
+        std::cerr << "Unsupported word length " << firstWordLength(answersText) << std::endl;
+        exit(1);
+    }
+}
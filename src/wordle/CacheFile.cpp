@@ -0,0 +1,357 @@
+#include "wordle/CacheFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#define CACHE_FILE_MAGIC "WRDLCACH"
+
+#define CACHE_FILE_VERSION 3
+
+#define CACHE_SECTION_ALIGNMENT 4096
+
+#define CACHE_BOOK_CONFIGURATION_LENGTH 64
+
+// matrix rows buildCacheFile computes between writes.
+#define CACHE_BUILD_TILE_BYTES (16 << 20)
+
+// binary cache: a header, the packed letter codes of the answer and guess
+// lists as read from the text files (4 bytes per word, 8 for seven
+// letters), then optionally the feedback matrix for
+// the game's guess list (the guesses followed by the answers) and an
+// opening book in the decision tree layout. sections are page aligned so
+// the matrix and book can be used straight from a shared mapping.
+struct CacheFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t wordLength;
+    // checksum of the raw word list files the cache was built from.
+    uint64_t sourceChecksum;
+    uint64_t answerCount;
+    uint64_t guessCount;
+    uint64_t answersOffset;
+    uint64_t guessesOffset;
+    // 0 when the cache holds no matrix.
+    uint64_t matrixOffset;
+    uint64_t matrixGuessCount;
+    uint64_t matrixAnswerCount;
+    // 0 when the cache holds no opening book.
+    uint64_t bookOffset;
+    uint64_t bookNodeCount;
+    uint64_t bookGuessCount;
+    char bookConfiguration[CACHE_BOOK_CONFIGURATION_LENGTH];
+};
+
+static uint64_t alignCacheOffset(uint64_t offset)
+{
+    return (offset + CACHE_SECTION_ALIGNMENT - 1) / CACHE_SECTION_ALIGNMENT * CACHE_SECTION_ALIGNMENT;
+}
+
+template <std::size_t Length>
+static std::unique_ptr<std::vector<Word<Length> > > readCachedWords(const MappedFile &file, uint64_t offset, uint64_t count)
+{
+    typedef PackedLetterCodes<Length> Codes;
+    if (offset > file.size() || count > (file.size() - offset) / sizeof(Codes))
+    {
+        throw std::runtime_error("Truncated cache file");
+    }
+    std::unique_ptr<std::vector<Word<Length> > > words(new std::vector<Word<Length> >);
+    words->reserve(count);
+    for (uint64_t i = 0; i < count; i++)
+    {
+        Codes packedCodes;
+        std::memcpy(&packedCodes, file.data() + offset + i * sizeof(Codes), sizeof(packedCodes));
+        words->push_back(Word<Length>::fromLetterCodes(packedCodes));
+    }
+    return words;
+}
+
+// whether every cell is a feedback id, so scoring can index histograms with
+// them unchecked.
+template <std::size_t Length>
+static bool hasValidFeedbackIds(const FeedbackCell<Length> *cells, uint64_t numCells)
+{
+    FeedbackCell<Length> largest = 0;
+    for (uint64_t i = 0; i < numCells; i++)
+    {
+        largest = std::max(largest, cells[i]);
+    }
+    return largest <= maxFeedbackId(Length);
+}
+
+// loadCacheFile for a file that passed the header checks; throws
+// std::runtime_error when the rest of it is malformed.
+template <std::size_t Length>
+static void readCacheFile(std::shared_ptr<MappedFile> file, CacheFileHeader &header, CachedDictionary<Length> &result)
+{
+    typedef typename FeedbackMatrix<Length>::Cell Cell;
+    result.answerWords = readCachedWords<Length>(*file, header.answersOffset, header.answerCount);
+    result.guessWords = readCachedWords<Length>(*file, header.guessesOffset, header.guessCount);
+    result.feedbackMatrix.reset();
+    if (header.matrixOffset != 0)
+    {
+        // the game's guesses are the guess list plus the answers not in it.
+        if (header.matrixAnswerCount != header.answerCount ||
+            header.matrixGuessCount < header.guessCount ||
+            header.matrixGuessCount - header.guessCount > header.answerCount)
+        {
+            throw std::runtime_error("Cache matrix does not match its word lists");
+        }
+        if (header.matrixOffset > file->size())
+        {
+            throw std::runtime_error("Truncated cache file");
+        }
+        // divided rather than multiplied, so huge counts can't overflow.
+        uint64_t maxCells = (file->size() - header.matrixOffset) / sizeof(Cell);
+        if (header.matrixAnswerCount > 0 && header.matrixGuessCount > maxCells / header.matrixAnswerCount)
+        {
+            throw std::runtime_error("Truncated cache file");
+        }
+        const Cell *cells = reinterpret_cast<const Cell *>(file->data() + header.matrixOffset);
+        if (!hasValidFeedbackIds<Length>(cells, header.matrixGuessCount * header.matrixAnswerCount))
+        {
+            throw std::runtime_error("Corrupt cache matrix");
+        }
+        result.feedbackMatrix = std::make_shared<FeedbackMatrix<Length> >(
+            file, cells, header.matrixGuessCount, header.matrixAnswerCount);
+    }
+    result.openingBook = OpeningBook<Length>();
+    if (header.bookOffset != 0)
+    {
+        header.bookConfiguration[CACHE_BOOK_CONFIGURATION_LENGTH - 1] = '\0';
+        result.openingBook.tree = DecisionTree<Length>::fromMapping(file, header.bookOffset, header.bookNodeCount, header.bookGuessCount);
+        result.openingBook.configuration = header.bookConfiguration;
+        result.openingBook.guessCount = header.bookGuessCount;
+    }
+}
+
+template <std::size_t Length>
+bool loadCacheFile(const std::string &path, uint64_t sourceChecksum, CachedDictionary<Length> &result)
+{
+    std::shared_ptr<MappedFile> file;
+    try
+    {
+        file = std::make_shared<MappedFile>(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        return false;
+    }
+    CacheFileHeader header;
+    if (file->size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CACHE_FILE_VERSION ||
+        header.wordLength != Length ||
+        header.sourceChecksum != sourceChecksum)
+    {
+        return false;
+    }
+
+    try
+    {
+        readCacheFile(file, header, result);
+    }
+    catch (const std::runtime_error &)
+    {
+        result = CachedDictionary<Length>();
+        return false;
+    }
+    return true;
+}
+
+template <std::size_t Length>
+static void writeCachedWords(std::ofstream &stream, const std::vector<Word<Length> > &words)
+{
+    for (const auto &word : words)
+    {
+        PackedLetterCodes<Length> packedCodes = word.packedLetterCodes();
+        stream.write(reinterpret_cast<const char *>(&packedCodes), sizeof(packedCodes));
+    }
+}
+
+static void padCacheFile(std::ofstream &stream, uint64_t offset)
+{
+    static const char zeros[CACHE_SECTION_ALIGNMENT] = {0};
+    uint64_t position = static_cast<uint64_t>(stream.tellp());
+    stream.write(zeros, static_cast<std::streamsize>(offset - position));
+}
+
+// header and word lists of a cache file with room for a matrixGuessCount
+// by matrixAnswerCount matrix (none when both are 0) and openingBook, left
+// positioned at the start of the matrix. returns the header written.
+template <std::size_t Length>
+static CacheFileHeader writeCacheFileStart(
+    std::ofstream &stream,
+    uint64_t sourceChecksum,
+    const std::vector<Word<Length> > &answerWords,
+    const std::vector<Word<Length> > &guessWords,
+    std::size_t matrixGuessCount,
+    std::size_t matrixAnswerCount,
+    const OpeningBook<Length> *openingBook)
+{
+    typedef PackedLetterCodes<Length> Codes;
+    CacheFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_FILE_VERSION;
+    header.wordLength = Length;
+    header.sourceChecksum = sourceChecksum;
+    header.answerCount = answerWords.size();
+    header.guessCount = guessWords.size();
+    header.answersOffset = alignCacheOffset(sizeof(header));
+    header.guessesOffset = alignCacheOffset(header.answersOffset + header.answerCount * sizeof(Codes));
+    if (matrixGuessCount > 0 || matrixAnswerCount > 0)
+    {
+        header.matrixOffset = alignCacheOffset(header.guessesOffset + header.guessCount * sizeof(Codes));
+        header.matrixGuessCount = matrixGuessCount;
+        header.matrixAnswerCount = matrixAnswerCount;
+    }
+    if (openingBook && openingBook->tree)
+    {
+        if (openingBook->configuration.size() >= CACHE_BOOK_CONFIGURATION_LENGTH)
+        {
+            throw std::runtime_error("Opening book configuration name too long");
+        }
+        uint64_t end = header.matrixOffset != 0
+                           ? header.matrixOffset + header.matrixGuessCount * header.matrixAnswerCount * sizeof(FeedbackCell<Length>)
+                           : header.guessesOffset + header.guessCount * sizeof(Codes);
+        header.bookOffset = alignCacheOffset(end);
+        header.bookNodeCount = openingBook->tree->numNodes();
+        header.bookGuessCount = openingBook->guessCount;
+        std::memcpy(header.bookConfiguration, openingBook->configuration.c_str(), openingBook->configuration.size());
+    }
+
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    padCacheFile(stream, header.answersOffset);
+    writeCachedWords(stream, answerWords);
+    padCacheFile(stream, header.guessesOffset);
+    writeCachedWords(stream, guessWords);
+    if (header.matrixOffset != 0)
+    {
+        padCacheFile(stream, header.matrixOffset);
+    }
+    return header;
+}
+
+static std::string temporaryCachePath(const std::string &path)
+{
+    return path + ".tmp";
+}
+
+static std::ofstream openCacheFile(const std::string &path)
+{
+    std::ofstream stream(temporaryCachePath(path), std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        throw std::runtime_error("Unable to write " + temporaryCachePath(path));
+    }
+    return stream;
+}
+
+static void commitCacheFile(std::ofstream &stream, const std::string &path)
+{
+    std::string temporaryPath = temporaryCachePath(path);
+    stream.close();
+    if (!stream || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Unable to write " + path);
+    }
+}
+
+template <std::size_t Length>
+void writeCacheFile(
+    const std::string &path,
+    uint64_t sourceChecksum,
+    const std::vector<Word<Length> > &answerWords,
+    const std::vector<Word<Length> > &guessWords,
+    const FeedbackMatrix<Length> *feedbackMatrix,
+    const OpeningBook<Length> *openingBook)
+{
+    std::ofstream stream = openCacheFile(path);
+    CacheFileHeader header = writeCacheFileStart(
+        stream, sourceChecksum, answerWords, guessWords,
+        feedbackMatrix ? feedbackMatrix->numGuesses() : 0,
+        feedbackMatrix ? feedbackMatrix->numAnswers() : 0,
+        openingBook);
+    if (feedbackMatrix)
+    {
+        stream.write(
+            reinterpret_cast<const char *>(feedbackMatrix->data()),
+            static_cast<std::streamsize>(feedbackMatrix->numGuesses() * feedbackMatrix->numAnswers() * sizeof(*feedbackMatrix->data())));
+    }
+    if (header.bookOffset != 0)
+    {
+        padCacheFile(stream, header.bookOffset);
+        openingBook->tree->writeNodes(stream);
+    }
+    commitCacheFile(stream, path);
+}
+
+template <std::size_t Length>
+void buildCacheFile(
+    const std::string &path,
+    uint64_t sourceChecksum,
+    const std::vector<Word<Length> > &answerWords,
+    const std::vector<Word<Length> > &guessWords,
+    const std::vector<Word<Length> > &matrixGuessWords,
+    const std::vector<Word<Length> > &matrixAnswerWords,
+    WorkerPool &pool,
+    const CacheBuildProgress &progress)
+{
+    typedef FeedbackCell<Length> Cell;
+    std::ofstream stream = openCacheFile(path);
+    writeCacheFileStart<Length>(
+        stream, sourceChecksum, answerWords, guessWords, matrixGuessWords.size(), matrixAnswerWords.size(), NULL);
+
+    PackedAnswers<Length> packedAnswers;
+    packedAnswers.assign(matrixAnswerWords);
+    std::size_t rowBytes = std::max<std::size_t>(matrixAnswerWords.size() * sizeof(Cell), 1);
+    std::size_t tileRows = std::max<std::size_t>(CACHE_BUILD_TILE_BYTES / rowBytes, 1);
+    std::vector<Cell> tile(std::min(tileRows, matrixGuessWords.size()) * matrixAnswerWords.size());
+    for (std::size_t beginRow = 0; beginRow < matrixGuessWords.size(); beginRow += tileRows)
+    {
+        std::size_t endRow = std::min(beginRow + tileRows, matrixGuessWords.size());
+        computeFeedbackRows(matrixGuessWords, packedAnswers, beginRow, endRow, tile.data(), pool);
+        stream.write(
+            reinterpret_cast<const char *>(tile.data()),
+            static_cast<std::streamsize>((endRow - beginRow) * matrixAnswerWords.size() * sizeof(Cell)));
+        if (!stream)
+        {
+            break;
+        }
+        if (progress)
+        {
+            progress(endRow, matrixGuessWords.size());
+        }
+    }
+    commitCacheFile(stream, path);
+}
+
+#define INSTANTIATE_CACHE_FILE(Length) \
+    template bool loadCacheFile(const std::string &path, uint64_t sourceChecksum, CachedDictionary<Length> &result); \
+    template void writeCacheFile( \
+        const std::string &path, \
+        uint64_t sourceChecksum, \
+        const std::vector<Word<Length> > &answerWords, \
+        const std::vector<Word<Length> > &guessWords, \
+        const FeedbackMatrix<Length> *feedbackMatrix, \
+        const OpeningBook<Length> *openingBook); \
+    template void buildCacheFile( \
+        const std::string &path, \
+        uint64_t sourceChecksum, \
+        const std::vector<Word<Length> > &answerWords, \
+        const std::vector<Word<Length> > &guessWords, \
+        const std::vector<Word<Length> > &matrixGuessWords, \
+        const std::vector<Word<Length> > &matrixAnswerWords, \
+        WorkerPool &pool, \
+        const CacheBuildProgress &progress);
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_CACHE_FILE)
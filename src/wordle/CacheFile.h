@@ -0,0 +1,72 @@
+#ifndef WORDLE_CACHE_FILE_H
+#define WORDLE_CACHE_FILE_H
+
+#include "wordle/DecisionTree.h"
+#include "wordle/FeedbackMatrix.h"
+#include "wordle/Word.h"
+#include "wordle/WorkerPool.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// the first turns of the decision tree for one solver configuration (see
+// WordleGame::configurationName), over a guessCount word guess list.
+template <std::size_t Length>
+struct OpeningBook
+{
+    std::shared_ptr<const DecisionTree<Length> > tree;
+    std::string configuration;
+    std::size_t guessCount;
+};
+
+// word lists, matrix and opening book loaded from a cache file.
+template <std::size_t Length>
+struct CachedDictionary
+{
+    std::unique_ptr<std::vector<Word<Length> > > answerWords;
+    std::unique_ptr<std::vector<Word<Length> > > guessWords;
+    std::shared_ptr<const FeedbackMatrix<Length> > feedbackMatrix;
+    // no tree when the cache holds no book.
+    OpeningBook<Length> openingBook;
+};
+
+// returns false, leaving result empty, if the file is missing, from another
+// version, was built from different word lists or another word length, or
+// is truncated or corrupt. every matrix cell is checked once here.
+template <std::size_t Length>
+bool loadCacheFile(const std::string &path, uint64_t sourceChecksum, CachedDictionary<Length> &result);
+
+// writes to a temporary file first and renames it into place, so processes
+// that already have the old cache mapped keep a consistent view. the matrix
+// and opening book may be NULL.
+template <std::size_t Length>
+void writeCacheFile(
+    const std::string &path,
+    uint64_t sourceChecksum,
+    const std::vector<Word<Length> > &answerWords,
+    const std::vector<Word<Length> > &guessWords,
+    const FeedbackMatrix<Length> *feedbackMatrix,
+    const OpeningBook<Length> *openingBook);
+
+// called with the matrix rows written so far and the total.
+typedef std::function<void(std::size_t, std::size_t)> CacheBuildProgress;
+
+// writeCacheFile, without an opening book, for a matrix of matrixGuessWords against matrixAnswerWords
+// that doesn't exist yet: it is computed on pool a tile of rows at a time,
+// each tile streamed to the file before the next, so the whole matrix is
+// never in memory.
+template <std::size_t Length>
+void buildCacheFile(
+    const std::string &path,
+    uint64_t sourceChecksum,
+    const std::vector<Word<Length> > &answerWords,
+    const std::vector<Word<Length> > &guessWords,
+    const std::vector<Word<Length> > &matrixGuessWords,
+    const std::vector<Word<Length> > &matrixAnswerWords,
+    WorkerPool &pool,
+    const CacheBuildProgress &progress);
+
+#endif
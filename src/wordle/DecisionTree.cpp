@@ -0,0 +1,205 @@
+#include "wordle/DecisionTree.h"
+
+#include "wordle/WordList.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#define DECISION_TREE_MAGIC "WRDLTREE"
+
+#define DECISION_TREE_VERSION 2
+
+// on disk the header is followed by the same three arrays.
+struct DecisionTreeHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t wordLength;
+    uint64_t sourceChecksum;
+    // checksum of the solver settings the tree was built with, see
+    // WordleGame::configurationName, so names of any length fit.
+    uint64_t configurationChecksum;
+    uint64_t guessCount;
+    uint64_t nodeCount;
+};
+
+template <std::size_t Length>
+const int32_t DecisionTree<Length>::NO_NODE;
+
+template <std::size_t Length>
+DecisionTree<Length>::DecisionTree(
+    std::vector<uint32_t> firstChildList,
+    std::vector<uint32_t> guessIndexList,
+    std::vector<Cell> feedbackIdList) : nodeCount(guessIndexList.size()),
+                                           ownedFirstChildren(std::move(firstChildList)),
+                                           ownedGuessIndices(std::move(guessIndexList)),
+                                           ownedFeedbackIds(std::move(feedbackIdList)),
+                                           firstChildren(ownedFirstChildren.data()),
+                                           guessIndices(ownedGuessIndices.data()),
+                                           feedbackIds(ownedFeedbackIds.data())
+{
+    if (ownedFirstChildren.size() != nodeCount + 1 || ownedFeedbackIds.size() != nodeCount)
+    {
+        throw std::runtime_error("Inconsistent decision tree");
+    }
+}
+
+template <std::size_t Length>
+DecisionTree<Length>::DecisionTree(
+    std::shared_ptr<const MappedFile> mappedFile,
+    const uint8_t *nodes,
+    std::size_t numNodes) : nodeCount(numNodes),
+                            mapping(mappedFile)
+{
+    firstChildren = reinterpret_cast<const uint32_t *>(nodes);
+    guessIndices = firstChildren + nodeCount + 1;
+    feedbackIds = reinterpret_cast<const Cell *>(guessIndices + nodeCount);
+}
+
+template <std::size_t Length>
+DecisionTree<Length>::~DecisionTree()
+{
+}
+
+template <std::size_t Length>
+std::shared_ptr<const DecisionTree<Length> > DecisionTree<Length>::load(
+    const std::string &path,
+    uint64_t sourceChecksum,
+    const std::string &configuration,
+    std::size_t guessCount)
+{
+    std::shared_ptr<MappedFile> file;
+    try
+    {
+        file = std::make_shared<MappedFile>(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        return std::shared_ptr<const DecisionTree<Length> >();
+    }
+    DecisionTreeHeader header;
+    if (file->size() < sizeof(header))
+    {
+        return std::shared_ptr<const DecisionTree<Length> >();
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, DECISION_TREE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DECISION_TREE_VERSION ||
+        header.wordLength != Length ||
+        header.sourceChecksum != sourceChecksum ||
+        header.configurationChecksum != checksumBytes(configuration) ||
+        header.guessCount != guessCount)
+    {
+        return std::shared_ptr<const DecisionTree<Length> >();
+    }
+    return fromMapping(file, sizeof(header), header.nodeCount, guessCount);
+}
+
+template <std::size_t Length>
+std::shared_ptr<const DecisionTree<Length> > DecisionTree<Length>::fromMapping(
+    std::shared_ptr<const MappedFile> file,
+    uint64_t offset,
+    std::size_t nodeCount,
+    std::size_t guessCount)
+{
+    if (offset > file->size() || nodeBytes(nodeCount) > file->size() - offset)
+    {
+        throw std::runtime_error("Truncated decision tree");
+    }
+    std::shared_ptr<const DecisionTree<Length> > tree(new DecisionTree<Length>(file, file->data() + offset, nodeCount));
+    for (std::size_t node = 0; node < tree->nodeCount; node++)
+    {
+        if (tree->guessIndices[node] >= guessCount ||
+            tree->firstChildren[node] > tree->firstChildren[node + 1] ||
+            tree->firstChildren[node + 1] > tree->nodeCount)
+        {
+            throw std::runtime_error("Corrupt decision tree");
+        }
+    }
+    return tree;
+}
+
+template <std::size_t Length>
+void DecisionTree<Length>::writeNodes(std::ostream &stream) const
+{
+    stream.write(reinterpret_cast<const char *>(firstChildren), (nodeCount + 1) * sizeof(uint32_t));
+    stream.write(reinterpret_cast<const char *>(guessIndices), nodeCount * sizeof(uint32_t));
+    stream.write(reinterpret_cast<const char *>(feedbackIds), nodeCount * sizeof(Cell));
+}
+
+template <std::size_t Length>
+uint64_t DecisionTree<Length>::nodeBytes(std::size_t nodeCount)
+{
+    return (nodeCount + 1) * sizeof(uint32_t) + nodeCount * (sizeof(uint32_t) + sizeof(Cell));
+}
+
+template <std::size_t Length>
+void DecisionTree<Length>::save(
+    const std::string &path,
+    uint64_t sourceChecksum,
+    const std::string &configuration,
+    std::size_t guessCount) const
+{
+    DecisionTreeHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, DECISION_TREE_MAGIC, sizeof(header.magic));
+    header.version = DECISION_TREE_VERSION;
+    header.wordLength = Length;
+    header.sourceChecksum = sourceChecksum;
+    header.configurationChecksum = checksumBytes(configuration);
+    header.guessCount = guessCount;
+    header.nodeCount = nodeCount;
+
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        throw std::runtime_error("Unable to write " + temporaryPath);
+    }
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeNodes(stream);
+    stream.close();
+    if (!stream || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Unable to write " + path);
+    }
+}
+
+template <std::size_t Length>
+int32_t DecisionTree<Length>::root() const
+{
+    return nodeCount > 0 ? 0 : NO_NODE;
+}
+
+template <std::size_t Length>
+std::size_t DecisionTree<Length>::numNodes() const
+{
+    return nodeCount;
+}
+
+template <std::size_t Length>
+uint32_t DecisionTree<Length>::guessIndex(int32_t node) const
+{
+    return guessIndices[node];
+}
+
+template <std::size_t Length>
+int32_t DecisionTree<Length>::child(int32_t node, int32_t feedbackId) const
+{
+    const Cell *begin = feedbackIds + firstChildren[node];
+    const Cell *end = feedbackIds + firstChildren[node + 1];
+    const Cell *found = std::lower_bound(begin, end, feedbackId);
+    if (found == end || *found != feedbackId)
+    {
+        return NO_NODE;
+    }
+    return static_cast<int32_t>(found - feedbackIds);
+}
+
+#define INSTANTIATE_DECISION_TREE(Length) template class DecisionTree<Length>;
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_DECISION_TREE)
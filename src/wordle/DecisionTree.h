@@ -0,0 +1,75 @@
+#ifndef WORDLE_DECISION_TREE_H
+#define WORDLE_DECISION_TREE_H
+
+#include "wordle/Feedback.h"
+#include "wordle/FeedbackMatrix.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// the guess the solver makes for every feedback history it can reach,
+// stored breadth first so the children of a node are consecutive nodes. per
+// node that leaves three arrays: the guess, the index of the first child
+// (with a sentinel past the last node), and the feedback id that leads to
+// the node from its parent. children are in increasing feedback id order.
+template <std::size_t Length>
+class DecisionTree
+{
+public:
+    typedef FeedbackCell<Length> Cell;
+
+    static const int32_t NO_NODE = -1;
+
+    DecisionTree(
+        std::vector<uint32_t> firstChildren,
+        std::vector<uint32_t> guessIndices,
+        std::vector<Cell> feedbackIds);
+    ~DecisionTree();
+
+    // returns NULL when the file is missing or was built from different word
+    // lists or settings.
+    static std::shared_ptr<const DecisionTree> load(
+        const std::string &path,
+        uint64_t sourceChecksum,
+        const std::string &configuration,
+        std::size_t guessCount);
+    void save(
+        const std::string &path,
+        uint64_t sourceChecksum,
+        const std::string &configuration,
+        std::size_t guessCount) const;
+    // a tree of nodeCount nodes laid out in file at offset the way
+    // writeNodes writes them, checked against a guessCount word guess list.
+    static std::shared_ptr<const DecisionTree> fromMapping(
+        std::shared_ptr<const MappedFile> file,
+        uint64_t offset,
+        std::size_t nodeCount,
+        std::size_t guessCount);
+    // the three arrays, back to back.
+    void writeNodes(std::ostream &stream) const;
+    static uint64_t nodeBytes(std::size_t nodeCount);
+
+    int32_t root() const;
+    std::size_t numNodes() const;
+    uint32_t guessIndex(int32_t node) const;
+    // the node reached from node by feedbackId, or NO_NODE.
+    int32_t child(int32_t node, int32_t feedbackId) const;
+
+private:
+    DecisionTree(std::shared_ptr<const MappedFile> mapping, const uint8_t *nodes, std::size_t nodeCount);
+
+    std::size_t nodeCount;
+    std::vector<uint32_t> ownedFirstChildren;
+    std::vector<uint32_t> ownedGuessIndices;
+    std::vector<Cell> ownedFeedbackIds;
+    std::shared_ptr<const MappedFile> mapping;
+    const uint32_t *firstChildren;
+    const uint32_t *guessIndices;
+    const Cell *feedbackIds;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "wordle/Feedback.h"
+
+#include "wordle/Profile.h"
+
+template <std::size_t Length>
+struct FeedbackCodeTable
+{
+    Feedback codes[maxFeedbackId(Length) + 1][Length];
+
+    constexpr FeedbackCodeTable() : codes()
+    {
+        for (int32_t feedbackId = 0; feedbackId <= maxFeedbackId(Length); feedbackId++)
+        {
+            int32_t remaining = feedbackId;
+            for (std::size_t i = 0; i < Length; i++)
+            {
+                codes[feedbackId][i] = static_cast<Feedback>(remaining % 3);
+                remaining /= 3;
+            }
+        }
+    }
+};
+
+template <std::size_t Length>
+const Feedback *feedbackCodesFromId(int32_t feedbackId)
+{
+    static constexpr FeedbackCodeTable<Length> table;
+    return table.codes[feedbackId];
+}
+
+template <std::size_t Length>
+void computeFeedbackCodes(const Word<Length> &guess, const Word<Length> &solution, Feedback *codes)
+{
+    PROFILE_COUNT(PROFILE_FEEDBACK_COMPUTATIONS, 1);
+    uint8_t unmatchedCounts[NUMBER_OF_LETTERS] = {0};
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        if (solution.letterCode(i) == guess.letterCode(i))
+        {
+            codes[i] = FEEDBACK_IN_POSITION;
+        }
+        else
+        {
+            codes[i] = FEEDBACK_NOT_IN_WORD;
+            unmatchedCounts[solution.letterCode(i)]++;
+        }
+    }
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        if (codes[i] == FEEDBACK_NOT_IN_WORD && unmatchedCounts[guess.letterCode(i)] > 0)
+        {
+            codes[i] = FEEDBACK_IN_WORD;
+            unmatchedCounts[guess.letterCode(i)]--;
+        }
+    }
+}
+
+template <std::size_t Length>
+bool GuessFeedback<Length>::isConsistentWith(const Word<Length> &word) const
+{
+    // word stays possible only if guessing it would have produced exactly
+    // this feedback.
+    PROFILE_COUNT(PROFILE_CONSISTENCY_CHECKS, 1);
+    Feedback codes[Length];
+    computeFeedbackCodes(guess, word, codes);
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        if (codes[i] != feedback[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t Length>
+int32_t GuessFeedback<Length>::feedbackId() const
+{
+    return feedbackIdFromCodes<Length>(feedback);
+}
+
+#define INSTANTIATE_FEEDBACK(Length) \
+    template const Feedback *feedbackCodesFromId<Length>(int32_t feedbackId); \
+    template void computeFeedbackCodes(const Word<Length> &guess, const Word<Length> &solution, Feedback *codes); \
+    template struct GuessFeedback<Length>;
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_FEEDBACK)
@@ -0,0 +1,104 @@
+#ifndef WORDLE_FEEDBACK_H
+#define WORDLE_FEEDBACK_H
+
+#include "wordle/Word.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#define FEEDBACK_NOT_IN_WORD 0
+
+#define FEEDBACK_IN_WORD 1
+
+#define FEEDBACK_IN_POSITION 2
+
+typedef uint8_t Feedback;
+
+// feedback ids are base-3 numbers with one digit per letter position, so
+// every letter in position, 3^length - 1, is the largest.
+constexpr int32_t maxFeedbackId(std::size_t length)
+{
+    return length == 0 ? 0 : maxFeedbackId(length - 1) * 3 + FEEDBACK_IN_POSITION;
+}
+
+// the smallest integer holding every feedback id of a Length-letter word:
+// a byte up to five letters.
+template <std::size_t Length>
+using FeedbackCell = typename std::conditional<(maxFeedbackId(Length) <= UINT8_MAX), uint8_t, uint16_t>::type;
+
+// candidates per feedback id for one guess. 16-bit counts keep a whole
+// five-letter histogram within 486 bytes; candidate sets of more than
+// UINT16_MAX answers use the wide counts instead.
+template <std::size_t Length>
+using FeedbackHistogram = std::array<uint16_t, maxFeedbackId(Length) + 1>;
+
+template <std::size_t Length>
+using WideFeedbackHistogram = std::array<uint32_t, maxFeedbackId(Length) + 1>;
+
+// the base-3 id of Length per-position codes.
+template <std::size_t Length>
+inline int32_t feedbackIdFromCodes(const Feedback *codes)
+{
+    int32_t result = 0;
+    for (std::size_t i = Length; i-- > 0;)
+    {
+        result = result * 3 + codes[i];
+    }
+    return result;
+}
+
+// the Length per-position codes of a feedback id, from a table built at
+// compile time.
+template <std::size_t Length>
+const Feedback *feedbackCodesFromId(int32_t feedbackId);
+
+// scores guess against solution the way wordle does: letters in position
+// are matched first, then the remaining guess letters are marked in word,
+// left to right, only while the solution still has an unmatched copy of
+// that letter.
+template <std::size_t Length>
+void computeFeedbackCodes(const Word<Length> &guess, const Word<Length> &solution, Feedback *codes);
+
+template <std::size_t Length>
+struct GuessFeedback
+{
+    Word<Length> guess;
+    Feedback feedback[Length];
+    GuessFeedback(Word<Length> guessWord, int32_t feedbackId) : guess(guessWord)
+    {
+        std::memcpy(feedback, feedbackCodesFromId<Length>(feedbackId), Length);
+    }
+    GuessFeedback(std::string guessString, std::string feedbackString) : guess(guessString)
+    {
+        if (feedbackString.size() != Length)
+        {
+            throw std::runtime_error("Invalid feedback length");
+        }
+
+        for (std::size_t i = 0; i < Length; i++)
+        {
+            switch (feedbackString[i])
+            {
+            case 'r':
+                feedback[i] = FEEDBACK_NOT_IN_WORD;
+                break;
+            case 'y':
+                feedback[i] = FEEDBACK_IN_WORD;
+                break;
+            case 'g':
+                feedback[i] = FEEDBACK_IN_POSITION;
+                break;
+            default:
+                throw std::runtime_error("Invalid feedback code");
+                break;
+            }
+        }
+    }
+
+    bool isConsistentWith(const Word<Length> &word) const;
+    int32_t feedbackId() const;
+};
+
+#endif
@@ -0,0 +1,130 @@
+#include "wordle/FeedbackConstraints.h"
+
+#include <algorithm>
+
+#define ALL_LETTERS ((1u << NUMBER_OF_LETTERS) - 1)
+
+template <std::size_t Length>
+FeedbackConstraints<Length>::FeedbackConstraints()
+{
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        allowedLetters[i] = ALL_LETTERS;
+    }
+    for (std::size_t letter = 0; letter < NUMBER_OF_LETTERS; letter++)
+    {
+        minCounts[letter] = 0;
+        maxCounts[letter] = Length;
+    }
+    updateLetterMasks();
+}
+
+template <std::size_t Length>
+FeedbackConstraints<Length>::FeedbackConstraints(const GuessFeedback<Length> &guessFeedback)
+    : FeedbackConstraints()
+{
+    uint8_t markedCounts[NUMBER_OF_LETTERS] = {0};
+    uint32_t notInWordLetters = 0;
+    bool possible = true;
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        uint8_t letter = guessFeedback.guess.letterCode(i);
+        uint32_t letterBit = 1u << letter;
+        switch (guessFeedback.feedback[i])
+        {
+        case FEEDBACK_IN_POSITION:
+            allowedLetters[i] = letterBit;
+            markedCounts[letter]++;
+            break;
+        case FEEDBACK_IN_WORD:
+            // copies are marked in word left to right, so one after a copy
+            // marked not in word can't happen.
+            possible = possible && (notInWordLetters & letterBit) == 0;
+            allowedLetters[i] &= ~letterBit;
+            markedCounts[letter]++;
+            break;
+        default:
+            allowedLetters[i] &= ~letterBit;
+            notInWordLetters |= letterBit;
+            break;
+        }
+    }
+    for (uint32_t mask = guessFeedback.guess.letterMask(); mask != 0; mask &= mask - 1)
+    {
+        uint32_t letter = static_cast<uint32_t>(__builtin_ctz(mask));
+        minCounts[letter] = markedCounts[letter];
+        if (notInWordLetters & (1u << letter))
+        {
+            maxCounts[letter] = markedCounts[letter];
+        }
+    }
+    if (!possible)
+    {
+        // feedback no answer could give: allow nothing.
+        allowedLetters[0] = 0;
+    }
+    updateLetterMasks();
+}
+
+template <std::size_t Length>
+FeedbackConstraints<Length> FeedbackConstraints<Length>::revealedHints(const GuessFeedback<Length> &guessFeedback)
+{
+    FeedbackConstraints hints;
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        uint8_t letter = guessFeedback.guess.letterCode(i);
+        if (guessFeedback.feedback[i] == FEEDBACK_IN_POSITION)
+        {
+            hints.allowedLetters[i] = 1u << letter;
+        }
+        if (guessFeedback.feedback[i] != FEEDBACK_NOT_IN_WORD)
+        {
+            hints.minCounts[letter]++;
+        }
+    }
+    hints.updateLetterMasks();
+    return hints;
+}
+
+template <std::size_t Length>
+void FeedbackConstraints<Length>::merge(const FeedbackConstraints &other)
+{
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        allowedLetters[i] &= other.allowedLetters[i];
+    }
+    for (std::size_t letter = 0; letter < NUMBER_OF_LETTERS; letter++)
+    {
+        minCounts[letter] = std::max(minCounts[letter], other.minCounts[letter]);
+        maxCounts[letter] = std::min(maxCounts[letter], other.maxCounts[letter]);
+    }
+    updateLetterMasks();
+}
+
+template <std::size_t Length>
+void FeedbackConstraints<Length>::updateLetterMasks()
+{
+    requiredLetters = 0;
+    forbiddenLetters = 0;
+    countedLetters = 0;
+    for (std::size_t letter = 0; letter < NUMBER_OF_LETTERS; letter++)
+    {
+        uint32_t letterBit = 1u << letter;
+        if (minCounts[letter] > 0)
+        {
+            requiredLetters |= letterBit;
+        }
+        if (maxCounts[letter] == 0)
+        {
+            forbiddenLetters |= letterBit;
+        }
+        if (minCounts[letter] > 1 || (maxCounts[letter] > 0 && maxCounts[letter] < Length))
+        {
+            countedLetters |= letterBit;
+        }
+    }
+}
+
+#define INSTANTIATE_FEEDBACK_CONSTRAINTS(Length) template class FeedbackConstraints<Length>;
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_FEEDBACK_CONSTRAINTS)
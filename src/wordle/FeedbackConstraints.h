@@ -0,0 +1,78 @@
+#ifndef WORDLE_FEEDBACK_CONSTRAINTS_H
+#define WORDLE_FEEDBACK_CONSTRAINTS_H
+
+#include "wordle/Feedback.h"
+#include "wordle/Word.h"
+
+#include <cstdint>
+
+// a feedback history compiled into what it says about the answer: the
+// letters each position can still hold, the letters the answer must and
+// must not contain, and bounds on how many copies of a letter it has. a
+// word allows them exactly when it is consistent with every feedback in the
+// history, so testing a word costs the same however long the history is.
+//
+// one feedback pins its in-position letters, rules its other guess letters
+// out of their positions, and gives each guess letter at least as many
+// copies as it was marked in position or in word; a copy marked not in word
+// makes that an exact count. merging histories intersects all of it.
+template <std::size_t Length>
+class FeedbackConstraints
+{
+public:
+    // no feedback yet, allowing every word.
+    FeedbackConstraints();
+    FeedbackConstraints(const GuessFeedback<Length> &guessFeedback);
+    // just what hard mode makes later guesses reuse: letters in position
+    // stay in position, and every copy marked in position or in word stays
+    // in the word.
+    static FeedbackConstraints revealedHints(const GuessFeedback<Length> &guessFeedback);
+
+    void merge(const FeedbackConstraints &other);
+
+    bool allows(const Word<Length> &word) const
+    {
+        uint32_t letters = word.letterMask();
+        if ((letters & requiredLetters) != requiredLetters || (letters & forbiddenLetters) != 0)
+        {
+            return false;
+        }
+        PackedLetterCodes<Length> codes = word.packedLetterCodes();
+        for (std::size_t i = 0; i < Length; i++)
+        {
+            if (!((allowedLetters[i] >> ((codes >> (LETTER_CODE_BITS * i)) & LETTER_CODE_MASK)) & 1))
+            {
+                return false;
+            }
+        }
+        for (uint32_t mask = letters & countedLetters; mask != 0; mask &= mask - 1)
+        {
+            uint32_t letter = static_cast<uint32_t>(__builtin_ctz(mask));
+            int32_t count = 0;
+            for (std::size_t i = 0; i < Length; i++)
+            {
+                count += ((codes >> (LETTER_CODE_BITS * i)) & LETTER_CODE_MASK) == letter;
+            }
+            if (count < minCounts[letter] || count > maxCounts[letter])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void updateLetterMasks();
+
+    // bit l of allowedLetters[i] is set while letter l can be at position i.
+    uint32_t allowedLetters[Length];
+    uint32_t requiredLetters;
+    uint32_t forbiddenLetters;
+    // letters the masks alone can't check: at least two copies, or a
+    // bounded number other than none.
+    uint32_t countedLetters;
+    uint8_t minCounts[NUMBER_OF_LETTERS];
+    uint8_t maxCounts[NUMBER_OF_LETTERS];
+};
+
+#endif
@@ -0,0 +1,412 @@
+#include "wordle/FeedbackKernels.h"
+
+#include "wordle/Profile.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define WORDLE_X86_KERNELS 1
+
+#elif defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#define WORDLE_NEON_KERNEL 1
+
+#endif
+
+template <std::size_t Length>
+const std::size_t PackedAnswers<Length>::BLOCK_SIZE;
+
+template <std::size_t Length>
+const uint8_t PackedAnswers<Length>::PADDING_CODE;
+
+template <std::size_t Length>
+PackedAnswers<Length>::PackedAnswers() : count(0)
+{
+}
+
+template <std::size_t Length>
+PackedAnswers<Length>::~PackedAnswers()
+{
+}
+
+template <std::size_t Length>
+void PackedAnswers<Length>::resize(std::size_t newCount)
+{
+    count = newCount;
+    std::size_t padded = (count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    for (auto &codes : letterCodes)
+    {
+        codes.assign(padded, PADDING_CODE);
+    }
+}
+
+template <std::size_t Length>
+void PackedAnswers<Length>::assign(const std::vector<Word<Length> > &words)
+{
+    resize(words.size());
+    for (std::size_t i = 0; i < count; i++)
+    {
+        for (std::size_t position = 0; position < Length; position++)
+        {
+            letterCodes[position][i] = words[i].letterCode(position);
+        }
+    }
+}
+
+template <std::size_t Length>
+void PackedAnswers<Length>::assign(const std::vector<Word<Length> > &words, const std::vector<uint32_t> &indices)
+{
+    resize(indices.size());
+    for (std::size_t i = 0; i < count; i++)
+    {
+        for (std::size_t position = 0; position < Length; position++)
+        {
+            letterCodes[position][i] = words[indices[i]].letterCode(position);
+        }
+    }
+}
+
+template <std::size_t Length>
+std::size_t PackedAnswers<Length>::size() const
+{
+    return count;
+}
+
+template <std::size_t Length>
+std::size_t PackedAnswers<Length>::paddedSize() const
+{
+    return letterCodes[0].size();
+}
+
+template <std::size_t Length>
+const uint8_t *PackedAnswers<Length>::position(int32_t index) const
+{
+    return letterCodes[index].data();
+}
+
+// the vector kernels add up the id digits of the first
+// LOW_FEEDBACK_POSITIONS positions in byte lanes, where they stay below 243,
+// and the digits of any later positions in a second set of byte lanes that
+// counts in units of 243 once both are widened to FeedbackCell.
+#define LOW_FEEDBACK_POSITIONS 5
+
+#define HIGH_FEEDBACK_WEIGHT 243
+
+// position weights of the base-3 feedback id.
+static const int32_t FEEDBACK_POSITION_WEIGHTS[MAX_WORD_LENGTH] = {1, 3, 9, 27, 81, 243, 729};
+
+// the same weights within the low or high byte lanes.
+static const uint8_t FEEDBACK_LANE_WEIGHTS[MAX_WORD_LENGTH] = {1, 3, 9, 27, 81, 1, 3};
+
+template <std::size_t Length>
+struct RepeatedGuessLetters
+{
+    // bit q of earlier[p] is set when q < p and the guess has the same
+    // letter at q and p.
+    uint8_t earlier[Length];
+
+    RepeatedGuessLetters(const uint8_t *guessCodes)
+    {
+        for (std::size_t p = 0; p < Length; p++)
+        {
+            earlier[p] = 0;
+            for (std::size_t q = 0; q < p; q++)
+            {
+                if (guessCodes[q] == guessCodes[p])
+                {
+                    earlier[p] |= 1 << q;
+                }
+            }
+        }
+    }
+};
+
+template <std::size_t Length>
+void computeFeedbackIdsScalar(const uint8_t *guessCodes, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds)
+{
+    RepeatedGuessLetters<Length> repeats(guessCodes);
+    const uint8_t *positions[Length];
+    for (std::size_t q = 0; q < Length; q++)
+    {
+        positions[q] = answers.position(q);
+    }
+    for (std::size_t i = 0; i < answers.paddedSize(); i++)
+    {
+        bool inPosition[Length];
+        for (std::size_t q = 0; q < Length; q++)
+        {
+            inPosition[q] = positions[q][i] == guessCodes[q];
+        }
+        int32_t feedbackId = 0;
+        for (std::size_t p = 0; p < Length; p++)
+        {
+            if (inPosition[p])
+            {
+                feedbackId += 2 * FEEDBACK_POSITION_WEIGHTS[p];
+                continue;
+            }
+            int32_t unmatched = 0;
+            int32_t usedEarlier = 0;
+            for (std::size_t q = 0; q < Length; q++)
+            {
+                unmatched += !inPosition[q] && positions[q][i] == guessCodes[p];
+                usedEarlier += ((repeats.earlier[p] >> q) & 1) && !inPosition[q];
+            }
+            if (unmatched > usedEarlier)
+            {
+                feedbackId += FEEDBACK_POSITION_WEIGHTS[p];
+            }
+        }
+        feedbackIds[i] = static_cast<FeedbackCell<Length> >(feedbackId);
+    }
+}
+
+#ifdef WORDLE_X86_KERNELS
+
+__attribute__((target("avx2"))) static inline void storeFeedbackIdsAvx2(uint8_t *feedbackIds, __m256i low, __m256i)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(feedbackIds), low);
+}
+
+__attribute__((target("avx2"))) static inline void storeFeedbackIdsAvx2(uint16_t *feedbackIds, __m256i low, __m256i high)
+{
+    __m256i weight = _mm256_set1_epi16(HIGH_FEEDBACK_WEIGHT);
+    __m256i first = _mm256_add_epi16(
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(low)),
+        _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(high)), weight));
+    __m256i second = _mm256_add_epi16(
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(low, 1)),
+        _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(high, 1)), weight));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(feedbackIds), first);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(feedbackIds + 16), second);
+}
+
+// compare results are 0 or -1 per byte, so subtracting them counts matches.
+template <std::size_t Length>
+__attribute__((target("avx2"))) void computeFeedbackIdsAvx2(
+    const uint8_t *guessCodes, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds)
+{
+    RepeatedGuessLetters<Length> repeats(guessCodes);
+    __m256i guessLetters[Length];
+    __m256i weights[Length];
+    for (std::size_t p = 0; p < Length; p++)
+    {
+        guessLetters[p] = _mm256_set1_epi8(static_cast<char>(guessCodes[p]));
+        weights[p] = _mm256_set1_epi8(static_cast<char>(FEEDBACK_LANE_WEIGHTS[p]));
+    }
+    for (std::size_t i = 0; i < answers.paddedSize(); i += 32)
+    {
+        __m256i letters[Length];
+        __m256i outOfPosition[Length];
+        for (std::size_t q = 0; q < Length; q++)
+        {
+            letters[q] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(answers.position(q) + i));
+            outOfPosition[q] = _mm256_xor_si256(
+                _mm256_cmpeq_epi8(letters[q], guessLetters[q]), _mm256_set1_epi8(-1));
+        }
+        __m256i ids[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+        for (std::size_t p = 0; p < Length; p++)
+        {
+            __m256i unmatched = _mm256_setzero_si256();
+            __m256i usedEarlier = _mm256_setzero_si256();
+            for (std::size_t q = 0; q < Length; q++)
+            {
+                unmatched = _mm256_sub_epi8(
+                    unmatched, _mm256_and_si256(outOfPosition[q], _mm256_cmpeq_epi8(letters[q], guessLetters[p])));
+                if ((repeats.earlier[p] >> q) & 1)
+                {
+                    usedEarlier = _mm256_sub_epi8(usedEarlier, outOfPosition[q]);
+                }
+            }
+            __m256i inWord = _mm256_and_si256(outOfPosition[p], _mm256_cmpgt_epi8(unmatched, usedEarlier));
+            __m256i inPosition = _mm256_andnot_si256(outOfPosition[p], _mm256_set1_epi8(-1));
+            __m256i &lane = ids[p >= LOW_FEEDBACK_POSITIONS];
+            lane = _mm256_add_epi8(lane, _mm256_and_si256(_mm256_or_si256(inWord, inPosition), weights[p]));
+            lane = _mm256_add_epi8(lane, _mm256_and_si256(inPosition, weights[p]));
+        }
+        storeFeedbackIdsAvx2(feedbackIds + i, ids[0], ids[1]);
+    }
+}
+
+static inline void storeFeedbackIdsSse2(uint8_t *feedbackIds, __m128i low, __m128i)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(feedbackIds), low);
+}
+
+static inline void storeFeedbackIdsSse2(uint16_t *feedbackIds, __m128i low, __m128i high)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i weight = _mm_set1_epi16(HIGH_FEEDBACK_WEIGHT);
+    __m128i first = _mm_add_epi16(
+        _mm_unpacklo_epi8(low, zero), _mm_mullo_epi16(_mm_unpacklo_epi8(high, zero), weight));
+    __m128i second = _mm_add_epi16(
+        _mm_unpackhi_epi8(low, zero), _mm_mullo_epi16(_mm_unpackhi_epi8(high, zero), weight));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(feedbackIds), first);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(feedbackIds + 8), second);
+}
+
+template <std::size_t Length>
+void computeFeedbackIdsSse2(const uint8_t *guessCodes, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds)
+{
+    RepeatedGuessLetters<Length> repeats(guessCodes);
+    __m128i guessLetters[Length];
+    __m128i weights[Length];
+    for (std::size_t p = 0; p < Length; p++)
+    {
+        guessLetters[p] = _mm_set1_epi8(static_cast<char>(guessCodes[p]));
+        weights[p] = _mm_set1_epi8(static_cast<char>(FEEDBACK_LANE_WEIGHTS[p]));
+    }
+    for (std::size_t i = 0; i < answers.paddedSize(); i += 16)
+    {
+        __m128i letters[Length];
+        __m128i outOfPosition[Length];
+        for (std::size_t q = 0; q < Length; q++)
+        {
+            letters[q] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(answers.position(q) + i));
+            outOfPosition[q] = _mm_xor_si128(_mm_cmpeq_epi8(letters[q], guessLetters[q]), _mm_set1_epi8(-1));
+        }
+        __m128i ids[2] = {_mm_setzero_si128(), _mm_setzero_si128()};
+        for (std::size_t p = 0; p < Length; p++)
+        {
+            __m128i unmatched = _mm_setzero_si128();
+            __m128i usedEarlier = _mm_setzero_si128();
+            for (std::size_t q = 0; q < Length; q++)
+            {
+                unmatched = _mm_sub_epi8(
+                    unmatched, _mm_and_si128(outOfPosition[q], _mm_cmpeq_epi8(letters[q], guessLetters[p])));
+                if ((repeats.earlier[p] >> q) & 1)
+                {
+                    usedEarlier = _mm_sub_epi8(usedEarlier, outOfPosition[q]);
+                }
+            }
+            __m128i inWord = _mm_and_si128(outOfPosition[p], _mm_cmpgt_epi8(unmatched, usedEarlier));
+            __m128i inPosition = _mm_andnot_si128(outOfPosition[p], _mm_set1_epi8(-1));
+            __m128i &lane = ids[p >= LOW_FEEDBACK_POSITIONS];
+            lane = _mm_add_epi8(lane, _mm_and_si128(_mm_or_si128(inWord, inPosition), weights[p]));
+            lane = _mm_add_epi8(lane, _mm_and_si128(inPosition, weights[p]));
+        }
+        storeFeedbackIdsSse2(feedbackIds + i, ids[0], ids[1]);
+    }
+}
+
+#endif
+
+#ifdef WORDLE_NEON_KERNEL
+
+static inline void storeFeedbackIdsNeon(uint8_t *feedbackIds, uint8x16_t low, uint8x16_t)
+{
+    vst1q_u8(feedbackIds, low);
+}
+
+static inline void storeFeedbackIdsNeon(uint16_t *feedbackIds, uint8x16_t low, uint8x16_t high)
+{
+    vst1q_u16(feedbackIds, vmlaq_n_u16(vmovl_u8(vget_low_u8(low)), vmovl_u8(vget_low_u8(high)), HIGH_FEEDBACK_WEIGHT));
+    vst1q_u16(feedbackIds + 8, vmlaq_n_u16(vmovl_u8(vget_high_u8(low)), vmovl_u8(vget_high_u8(high)), HIGH_FEEDBACK_WEIGHT));
+}
+
+template <std::size_t Length>
+void computeFeedbackIdsNeon(const uint8_t *guessCodes, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds)
+{
+    RepeatedGuessLetters<Length> repeats(guessCodes);
+    uint8x16_t guessLetters[Length];
+    uint8x16_t weights[Length];
+    for (std::size_t p = 0; p < Length; p++)
+    {
+        guessLetters[p] = vdupq_n_u8(guessCodes[p]);
+        weights[p] = vdupq_n_u8(FEEDBACK_LANE_WEIGHTS[p]);
+    }
+    for (std::size_t i = 0; i < answers.paddedSize(); i += 16)
+    {
+        uint8x16_t letters[Length];
+        uint8x16_t outOfPosition[Length];
+        for (std::size_t q = 0; q < Length; q++)
+        {
+            letters[q] = vld1q_u8(answers.position(q) + i);
+            outOfPosition[q] = vmvnq_u8(vceqq_u8(letters[q], guessLetters[q]));
+        }
+        uint8x16_t ids[2] = {vdupq_n_u8(0), vdupq_n_u8(0)};
+        for (std::size_t p = 0; p < Length; p++)
+        {
+            uint8x16_t unmatched = vdupq_n_u8(0);
+            uint8x16_t usedEarlier = vdupq_n_u8(0);
+            for (std::size_t q = 0; q < Length; q++)
+            {
+                unmatched = vsubq_u8(unmatched, vandq_u8(outOfPosition[q], vceqq_u8(letters[q], guessLetters[p])));
+                if ((repeats.earlier[p] >> q) & 1)
+                {
+                    usedEarlier = vsubq_u8(usedEarlier, outOfPosition[q]);
+                }
+            }
+            uint8x16_t inWord = vandq_u8(outOfPosition[p], vcgtq_u8(unmatched, usedEarlier));
+            uint8x16_t inPosition = vmvnq_u8(outOfPosition[p]);
+            uint8x16_t &lane = ids[p >= LOW_FEEDBACK_POSITIONS];
+            lane = vaddq_u8(lane, vandq_u8(vorrq_u8(inWord, inPosition), weights[p]));
+            lane = vaddq_u8(lane, vandq_u8(inPosition, weights[p]));
+        }
+        storeFeedbackIdsNeon(feedbackIds + i, ids[0], ids[1]);
+    }
+}
+
+#endif
+
+template <std::size_t Length>
+std::vector<NamedFeedbackKernel<Length> > availableFeedbackKernels()
+{
+    std::vector<NamedFeedbackKernel<Length> > kernels;
+    kernels.push_back({"scalar", computeFeedbackIdsScalar<Length>});
+#ifdef WORDLE_X86_KERNELS
+    kernels.push_back({"sse2", computeFeedbackIdsSse2<Length>});
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernels.push_back({"avx2", computeFeedbackIdsAvx2<Length>});
+    }
+#elif defined(WORDLE_NEON_KERNEL)
+    kernels.push_back({"neon", computeFeedbackIdsNeon<Length>});
+#endif
+    return kernels;
+}
+
+template <std::size_t Length>
+FeedbackKernel<Length> selectFeedbackKernel()
+{
+#ifdef WORDLE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return computeFeedbackIdsAvx2<Length>;
+    }
+    return computeFeedbackIdsSse2<Length>;
+#elif defined(WORDLE_NEON_KERNEL)
+    return computeFeedbackIdsNeon<Length>;
+#else
+    return computeFeedbackIdsScalar<Length>;
+#endif
+}
+
+template <std::size_t Length>
+void computeFeedbackIds(const Word<Length> &guess, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds)
+{
+    static const FeedbackKernel<Length> kernel = selectFeedbackKernel<Length>();
+    PROFILE_COUNT(PROFILE_FEEDBACK_COMPUTATIONS, answers.size());
+    uint8_t guessCodes[Length];
+    for (std::size_t p = 0; p < Length; p++)
+    {
+        guessCodes[p] = guess.letterCode(p);
+    }
+    kernel(guessCodes, answers, feedbackIds);
+}
+
+#define INSTANTIATE_FEEDBACK_KERNELS(Length) \
+    template class PackedAnswers<Length>; \
+    template void computeFeedbackIdsScalar( \
+        const uint8_t *guessCodes, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds); \
+    template std::vector<NamedFeedbackKernel<Length> > availableFeedbackKernels<Length>(); \
+    template FeedbackKernel<Length> selectFeedbackKernel<Length>(); \
+    template void computeFeedbackIds( \
+        const Word<Length> &guess, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds);
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_FEEDBACK_KERNELS)
@@ -0,0 +1,70 @@
+#ifndef WORDLE_FEEDBACK_KERNELS_H
+#define WORDLE_FEEDBACK_KERNELS_H
+
+#include "wordle/Feedback.h"
+
+#include <cstddef>
+#include <vector>
+
+// candidate answers stored as one array of letter codes per position, so a
+// kernel can compare a guess letter against a whole block of answers at once.
+template <std::size_t Length>
+class PackedAnswers
+{
+public:
+    // kernels read and write whole blocks, so the arrays are padded up to a
+    // multiple of BLOCK_SIZE with a code that never matches a letter.
+    static const std::size_t BLOCK_SIZE = 32;
+    static const uint8_t PADDING_CODE = 0xff;
+
+    PackedAnswers();
+    ~PackedAnswers();
+
+    void assign(const std::vector<Word<Length> > &words);
+    void assign(const std::vector<Word<Length> > &words, const std::vector<uint32_t> &indices);
+    std::size_t size() const;
+    std::size_t paddedSize() const;
+    const uint8_t *position(int32_t index) const;
+
+private:
+    void resize(std::size_t newCount);
+
+    std::size_t count;
+    std::array<std::vector<uint8_t>, Length> letterCodes;
+};
+
+// all kernels write paddedSize() ids, one per answer slot, given the guess
+// as letter codes. they follow the same rules as computeFeedbackCodes, per
+// lane: an out-of-position guess letter is in word when the answer has more
+// unmatched copies of it than there are out-of-position copies earlier in
+// the guess. which earlier guess positions repeat a letter only depends on
+// the guess, so that part is worked out once per call.
+template <std::size_t Length>
+using FeedbackKernel = void (*)(const uint8_t *guessCodes, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds);
+
+// the portable kernel every other one is checked against.
+template <std::size_t Length>
+void computeFeedbackIdsScalar(const uint8_t *guessCodes, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds);
+
+template <std::size_t Length>
+struct NamedFeedbackKernel
+{
+    const char *name;
+    FeedbackKernel<Length> kernel;
+};
+
+// every kernel built in that the cpu supports, scalar first, so they can be
+// checked against each other.
+template <std::size_t Length>
+std::vector<NamedFeedbackKernel<Length> > availableFeedbackKernels();
+
+// the widest kernel the cpu supports.
+template <std::size_t Length>
+FeedbackKernel<Length> selectFeedbackKernel();
+
+// feedback id of guess against every answer slot, using the widest kernel
+// the cpu supports. feedbackIds must have room for answers.paddedSize() ids.
+template <std::size_t Length>
+void computeFeedbackIds(const Word<Length> &guess, const PackedAnswers<Length> &answers, FeedbackCell<Length> *feedbackIds);
+
+#endif
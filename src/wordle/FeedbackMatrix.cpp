@@ -0,0 +1,320 @@
+#include "wordle/FeedbackMatrix.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path) : address(NULL), length(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Unable to open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        throw std::runtime_error("Unable to map " + path);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    address = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        throw std::runtime_error("Unable to map " + path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    munmap(address, length);
+}
+
+const uint8_t *MappedFile::data() const
+{
+    return static_cast<const uint8_t *>(address);
+}
+
+std::size_t MappedFile::size() const
+{
+    return length;
+}
+
+template <std::size_t Length>
+void computeFeedbackRows(
+    const std::vector<Word<Length> > &guessWords,
+    const PackedAnswers<Length> &packedAnswers,
+    std::size_t beginRow,
+    std::size_t endRow,
+    FeedbackCell<Length> *cells,
+    WorkerPool &pool)
+{
+    // the kernels write whole padded rows, so each worker fills its own row
+    // buffer and copies out just the answers.
+    std::size_t answerCount = packedAnswers.size();
+    std::vector<std::vector<FeedbackCell<Length> > > rowBuffers(
+        pool.numWorkers(), std::vector<FeedbackCell<Length> >(packedAnswers.paddedSize()));
+    pool.parallelFor(
+        endRow - beginRow, 16,
+        [&](std::size_t worker, std::size_t begin, std::size_t end)
+        {
+            std::vector<FeedbackCell<Length> > &feedbackIds = rowBuffers[worker];
+            for (std::size_t row = begin; row < end; row++)
+            {
+                computeFeedbackIds(guessWords[beginRow + row], packedAnswers, feedbackIds.data());
+                std::copy(feedbackIds.begin(), feedbackIds.begin() + answerCount, cells + row * answerCount);
+            }
+        });
+}
+
+template <std::size_t Length>
+FeedbackMatrix<Length>::FeedbackMatrix(
+    const std::vector<Word<Length> > &guessWords,
+    const std::vector<Word<Length> > &answerWords) : guessCount(guessWords.size()),
+                                                     answerCount(answerWords.size()),
+                                                     ownedCells(guessWords.size() * answerWords.size())
+{
+    PackedAnswers<Length> packedAnswers;
+    packedAnswers.assign(answerWords);
+    std::vector<Cell> feedbackIds(packedAnswers.paddedSize());
+    for (std::size_t guessIndex = 0; guessIndex < guessCount; guessIndex++)
+    {
+        computeFeedbackIds(guessWords[guessIndex], packedAnswers, feedbackIds.data());
+        std::copy(feedbackIds.begin(), feedbackIds.begin() + answerCount, ownedCells.begin() + guessIndex * answerCount);
+    }
+    cells = ownedCells.data();
+}
+
+template <std::size_t Length>
+FeedbackMatrix<Length>::FeedbackMatrix(
+    const std::vector<Word<Length> > &guessWords,
+    const std::vector<Word<Length> > &answerWords,
+    WorkerPool &pool) : guessCount(guessWords.size()),
+                        answerCount(answerWords.size()),
+                        ownedCells(guessWords.size() * answerWords.size())
+{
+    PackedAnswers<Length> packedAnswers;
+    packedAnswers.assign(answerWords);
+    computeFeedbackRows(guessWords, packedAnswers, 0, guessCount, ownedCells.data(), pool);
+    cells = ownedCells.data();
+}
+
+template <std::size_t Length>
+FeedbackMatrix<Length>::FeedbackMatrix(
+    std::shared_ptr<const MappedFile> mappedFile,
+    const Cell *mappedCells,
+    std::size_t numGuesses,
+    std::size_t numAnswers) : guessCount(numGuesses),
+                              answerCount(numAnswers),
+                              mapping(mappedFile),
+                              cells(mappedCells)
+{
+}
+
+template <std::size_t Length>
+FeedbackMatrix<Length>::~FeedbackMatrix()
+{
+}
+
+template <std::size_t Length>
+std::size_t FeedbackMatrix<Length>::numGuesses() const
+{
+    return guessCount;
+}
+
+template <std::size_t Length>
+std::size_t FeedbackMatrix<Length>::numAnswers() const
+{
+    return answerCount;
+}
+
+template <std::size_t Length>
+typename FeedbackMatrix<Length>::Cell FeedbackMatrix<Length>::feedbackId(std::size_t guessIndex, std::size_t answerIndex) const
+{
+    return cells[guessIndex * answerCount + answerIndex];
+}
+
+template <std::size_t Length>
+const typename FeedbackMatrix<Length>::Cell *FeedbackMatrix<Length>::row(std::size_t guessIndex) const
+{
+    return &cells[guessIndex * answerCount];
+}
+
+template <std::size_t Length>
+const typename FeedbackMatrix<Length>::Cell *FeedbackMatrix<Length>::data() const
+{
+    return cells;
+}
+
+template <std::size_t Length>
+const std::size_t FeedbackBlockCache<Length>::ROWS_PER_BLOCK;
+
+template <std::size_t Length>
+FeedbackBlockCache<Length>::Block::Block(
+    std::size_t firstGuessIndex,
+    std::size_t numRows,
+    std::size_t numAnswers) : firstGuess(firstGuessIndex),
+                              rowCount(numRows),
+                              answerCount(numAnswers),
+                              cells(numRows * numAnswers)
+{
+}
+
+template <std::size_t Length>
+const typename FeedbackBlockCache<Length>::Cell *FeedbackBlockCache<Length>::Block::row(std::size_t guessIndex) const
+{
+    return &cells[(guessIndex - firstGuess) * answerCount];
+}
+
+template <std::size_t Length>
+FeedbackBlockCache<Length>::FeedbackBlockCache(
+    std::shared_ptr<const std::vector<Word<Length> > > guessWordList,
+    std::shared_ptr<const std::vector<Word<Length> > > answerWordList,
+    std::size_t maxBytes) : guessWords(guessWordList),
+                            slots((guessWordList->size() + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK),
+                            numLookups(0),
+                            hits(0),
+                            misses(0)
+{
+    packedAnswers.assign(*answerWordList);
+    std::size_t blockBytes = std::max<std::size_t>(ROWS_PER_BLOCK * answerWordList->size() * sizeof(Cell), 1);
+    blockLimit = maxBytes / blockBytes;
+}
+
+template <std::size_t Length>
+FeedbackBlockCache<Length>::~FeedbackBlockCache()
+{
+}
+
+template <std::size_t Length>
+std::shared_ptr<const typename FeedbackBlockCache<Length>::Block> FeedbackBlockCache<Length>::blockFor(std::size_t guessIndex)
+{
+    std::size_t blockIndex = guessIndex / ROWS_PER_BLOCK;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Slot &slot = slots[blockIndex];
+        slot.lastUse = ++numLookups;
+        if (slot.block)
+        {
+            hits++;
+            recency.splice(recency.begin(), recency, slot.recency);
+            return slot.block;
+        }
+        misses++;
+        if (!hasRoom())
+        {
+            return std::shared_ptr<const Block>();
+        }
+    }
+    // computed unlocked, so two workers may both compute a block that is
+    // missing; the second just takes the first one's copy.
+    std::shared_ptr<const Block> block = computeBlock(blockIndex);
+    std::lock_guard<std::mutex> lock(mutex);
+    Slot &slot = slots[blockIndex];
+    if (slot.block)
+    {
+        return slot.block;
+    }
+    if (!hasRoom())
+    {
+        return block;
+    }
+    if (recency.size() >= blockLimit)
+    {
+        slots[recency.back()].block.reset();
+        recency.pop_back();
+    }
+    slot.block = block;
+    slot.recency = recency.insert(recency.begin(), blockIndex);
+    return block;
+}
+
+template <std::size_t Length>
+std::shared_ptr<const typename FeedbackBlockCache<Length>::Block> FeedbackBlockCache<Length>::cachedBlock(std::size_t guessIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Slot &slot = slots[guessIndex / ROWS_PER_BLOCK];
+    if (!slot.block)
+    {
+        misses++;
+        return slot.block;
+    }
+    // not a lookup of its own, or these would age the blocks that are
+    // scanned.
+    hits++;
+    slot.lastUse = numLookups;
+    recency.splice(recency.begin(), recency, slot.recency);
+    return slot.block;
+}
+
+template <std::size_t Length>
+bool FeedbackBlockCache<Length>::hasRoom() const
+{
+    if (recency.size() < blockLimit)
+    {
+        return true;
+    }
+    return blockLimit > 0 && numLookups - slots[recency.back()].lastUse > slots.size();
+}
+
+template <std::size_t Length>
+std::shared_ptr<const typename FeedbackBlockCache<Length>::Block> FeedbackBlockCache<Length>::computeBlock(std::size_t blockIndex) const
+{
+    std::size_t firstGuess = blockIndex * ROWS_PER_BLOCK;
+    std::size_t numRows = std::min(ROWS_PER_BLOCK, guessWords->size() - firstGuess);
+    std::shared_ptr<Block> block = std::make_shared<Block>(firstGuess, numRows, packedAnswers.size());
+    std::vector<Cell> feedbackIds(packedAnswers.paddedSize());
+    for (std::size_t row = 0; row < numRows; row++)
+    {
+        computeFeedbackIds((*guessWords)[firstGuess + row], packedAnswers, feedbackIds.data());
+        std::copy(feedbackIds.begin(), feedbackIds.begin() + packedAnswers.size(), block->cells.begin() + row * packedAnswers.size());
+    }
+    return block;
+}
+
+template <std::size_t Length>
+std::size_t FeedbackBlockCache<Length>::numGuesses() const
+{
+    return guessWords->size();
+}
+
+template <std::size_t Length>
+std::size_t FeedbackBlockCache<Length>::numAnswers() const
+{
+    return packedAnswers.size();
+}
+
+template <std::size_t Length>
+std::size_t FeedbackBlockCache<Length>::maxBlocks() const
+{
+    return blockLimit;
+}
+
+template <std::size_t Length>
+uint64_t FeedbackBlockCache<Length>::numHits() const
+{
+    return hits.load();
+}
+
+template <std::size_t Length>
+uint64_t FeedbackBlockCache<Length>::numMisses() const
+{
+    return misses.load();
+}
+
+#define INSTANTIATE_FEEDBACK_MATRIX(Length) \
+    template void computeFeedbackRows( \
+        const std::vector<Word<Length> > &guessWords, \
+        const PackedAnswers<Length> &packedAnswers, \
+        std::size_t beginRow, \
+        std::size_t endRow, \
+        FeedbackCell<Length> *cells, \
+        WorkerPool &pool); \
+    template class FeedbackMatrix<Length>; \
+    template class FeedbackBlockCache<Length>;
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_FEEDBACK_MATRIX)
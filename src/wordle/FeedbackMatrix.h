@@ -0,0 +1,164 @@
+#ifndef WORDLE_FEEDBACK_MATRIX_H
+#define WORDLE_FEEDBACK_MATRIX_H
+
+#include "wordle/Feedback.h"
+#include "wordle/FeedbackKernels.h"
+#include "wordle/WorkerPool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// read-only shared mapping of a whole file, unmapped when the last owner
+// goes away.
+class MappedFile
+{
+public:
+    MappedFile(const std::string &path);
+    ~MappedFile();
+
+    const uint8_t *data() const;
+    std::size_t size() const;
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    void *address;
+    std::size_t length;
+};
+
+// rows [beginRow, endRow) of the feedback ids of guessWords against
+// packedAnswers, packed one row after another into cells and shared out
+// between pool's workers a few rows at a time.
+template <std::size_t Length>
+void computeFeedbackRows(
+    const std::vector<Word<Length> > &guessWords,
+    const PackedAnswers<Length> &packedAnswers,
+    std::size_t beginRow,
+    std::size_t endRow,
+    FeedbackCell<Length> *cells,
+    WorkerPool &pool);
+
+// feedback ids for every guess/answer pair, computed once up front so that
+// scoring a guess is a row of table lookups.
+template <std::size_t Length>
+class FeedbackMatrix
+{
+public:
+    typedef FeedbackCell<Length> Cell;
+
+    FeedbackMatrix(const std::vector<Word<Length> > &guessWords, const std::vector<Word<Length> > &answerWords);
+    FeedbackMatrix(
+        const std::vector<Word<Length> > &guessWords,
+        const std::vector<Word<Length> > &answerWords,
+        WorkerPool &pool);
+    // cells that live inside a mapped cache file, which the matrix keeps open.
+    FeedbackMatrix(
+        std::shared_ptr<const MappedFile> mapping,
+        const Cell *cells,
+        std::size_t guessCount,
+        std::size_t answerCount);
+    ~FeedbackMatrix();
+
+    std::size_t numGuesses() const;
+    std::size_t numAnswers() const;
+    Cell feedbackId(std::size_t guessIndex, std::size_t answerIndex) const;
+    const Cell *row(std::size_t guessIndex) const;
+    const Cell *data() const;
+
+private:
+    std::size_t guessCount;
+    std::size_t answerCount;
+    std::vector<Cell> ownedCells;
+    std::shared_ptr<const MappedFile> mapping;
+    const Cell *cells;
+};
+
+// the feedback matrix for word lists too big to hold it whole: rows are
+// computed ROWS_PER_BLOCK at a time when scoring first asks for them, and
+// at most maxBytes of blocks are kept. once full, the least recently used
+// block only makes way for a missing one if it went unused for as many
+// lookups as there are blocks. a pass over more blocks than fit would
+// otherwise evict each block just before it is wanted again, recomputing
+// every one every pass; this way the cached blocks stay and the others are
+// not computed at all.
+template <std::size_t Length>
+class FeedbackBlockCache
+{
+public:
+    typedef FeedbackCell<Length> Cell;
+
+    static const std::size_t ROWS_PER_BLOCK = 64;
+
+    // consecutive rows, starting at firstGuess.
+    class Block
+    {
+    public:
+        Block(std::size_t firstGuessIndex, std::size_t numRows, std::size_t numAnswers);
+
+        const Cell *row(std::size_t guessIndex) const;
+
+    private:
+        friend class FeedbackBlockCache;
+
+        std::size_t firstGuess;
+        std::size_t rowCount;
+        std::size_t answerCount;
+        std::vector<Cell> cells;
+    };
+
+    FeedbackBlockCache(
+        std::shared_ptr<const std::vector<Word<Length> > > guessWords,
+        std::shared_ptr<const std::vector<Word<Length> > > answerWords,
+        std::size_t maxBytes);
+    ~FeedbackBlockCache();
+
+    // the block with guessIndex's row, valid for as long as it is held, or
+    // NULL when it is not cached and the cache has no room for it, for the
+    // caller to compute the feedback it needs itself.
+    std::shared_ptr<const Block> blockFor(std::size_t guessIndex);
+    // blockFor that never computes a block, for callers needing so few
+    // cells of the row that computing them beats filling a block.
+    std::shared_ptr<const Block> cachedBlock(std::size_t guessIndex);
+    std::size_t numGuesses() const;
+    std::size_t numAnswers() const;
+    std::size_t maxBlocks() const;
+    uint64_t numHits() const;
+    uint64_t numMisses() const;
+
+private:
+    FeedbackBlockCache(const FeedbackBlockCache &);
+    FeedbackBlockCache &operator=(const FeedbackBlockCache &);
+
+    struct Slot
+    {
+        std::shared_ptr<const Block> block;
+        uint64_t lastUse;
+        // position in recency, valid while block is set.
+        std::list<std::size_t>::iterator recency;
+    };
+
+    std::shared_ptr<const Block> computeBlock(std::size_t blockIndex) const;
+    // whether a missing block may be cached now; called with mutex held.
+    bool hasRoom() const;
+
+    const std::shared_ptr<const std::vector<Word<Length> > > guessWords;
+    PackedAnswers<Length> packedAnswers;
+    std::size_t blockLimit;
+    std::mutex mutex;
+    std::vector<Slot> slots;
+    // indices of cached blocks, most recently used first.
+    std::list<std::size_t> recency;
+    // lookups so far, the clock of Slot::lastUse.
+    uint64_t numLookups;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+};
+
+#endif
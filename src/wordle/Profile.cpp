@@ -0,0 +1,124 @@
+#include "wordle/Profile.h"
+
+#include <algorithm>
+
+#ifdef WORDLE_PROFILE
+
+std::mutex Profile::registryMutex;
+
+std::vector<Profile *> Profile::registry;
+
+uint64_t Profile::exitedCounters[PROFILE_COUNTER_COUNT];
+
+uint64_t Profile::exitedTimerCalls[PROFILE_TIMER_COUNT];
+
+uint64_t Profile::exitedTimerNanoseconds[PROFILE_TIMER_COUNT];
+
+static const char *const PROFILE_COUNTER_NAMES[PROFILE_COUNTER_COUNT] = {
+    "feedback_computations",
+    "consistency_checks",
+    "guesses_scored",
+    "transposition_hits",
+    "transposition_misses",
+    "tree_hits"};
+
+static const char *const PROFILE_TIMER_NAMES[PROFILE_TIMER_COUNT] = {
+    "get_guess",
+    "filtering",
+    "scoring",
+    "reduction",
+    "lookahead"};
+
+Profile::Profile()
+{
+    for (auto &counter : counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (int32_t timer = 0; timer < PROFILE_TIMER_COUNT; timer++)
+    {
+        timerCalls[timer].store(0, std::memory_order_relaxed);
+        timerNanoseconds[timer].store(0, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.push_back(this);
+}
+
+Profile::~Profile()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    add(exitedCounters, counters, PROFILE_COUNTER_COUNT);
+    add(exitedTimerCalls, timerCalls, PROFILE_TIMER_COUNT);
+    add(exitedTimerNanoseconds, timerNanoseconds, PROFILE_TIMER_COUNT);
+    registry.erase(std::find(registry.begin(), registry.end(), this));
+}
+
+Profile &Profile::forThread()
+{
+    thread_local Profile profile;
+    return profile;
+}
+
+void Profile::add(uint64_t *totals, const std::atomic<uint64_t> *values, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        totals[i] += values[i].load(std::memory_order_relaxed);
+    }
+}
+
+void Profile::count(ProfileCounter counter, uint64_t amount)
+{
+    // a plain load and store: only this thread ever writes it.
+    counters[counter].store(counters[counter].load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void Profile::time(ProfileTimer timer, uint64_t nanoseconds)
+{
+    timerCalls[timer].store(timerCalls[timer].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    timerNanoseconds[timer].store(timerNanoseconds[timer].load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+}
+
+void Profile::writeJson(std::ostream &stream)
+{
+    uint64_t totalCounters[PROFILE_COUNTER_COUNT];
+    uint64_t totalTimerCalls[PROFILE_TIMER_COUNT];
+    uint64_t totalTimerNanoseconds[PROFILE_TIMER_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::copy(exitedCounters, exitedCounters + PROFILE_COUNTER_COUNT, totalCounters);
+        std::copy(exitedTimerCalls, exitedTimerCalls + PROFILE_TIMER_COUNT, totalTimerCalls);
+        std::copy(exitedTimerNanoseconds, exitedTimerNanoseconds + PROFILE_TIMER_COUNT, totalTimerNanoseconds);
+        for (auto profile : registry)
+        {
+            add(totalCounters, profile->counters, PROFILE_COUNTER_COUNT);
+            add(totalTimerCalls, profile->timerCalls, PROFILE_TIMER_COUNT);
+            add(totalTimerNanoseconds, profile->timerNanoseconds, PROFILE_TIMER_COUNT);
+        }
+    }
+    stream << "{\"counters\":{";
+    for (int32_t counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+    {
+        stream << (counter > 0 ? "," : "") << "\"" << PROFILE_COUNTER_NAMES[counter] << "\":" << totalCounters[counter];
+    }
+    stream << "},\"timers\":{";
+    for (int32_t timer = 0; timer < PROFILE_TIMER_COUNT; timer++)
+    {
+        stream << (timer > 0 ? "," : "") << "\"" << PROFILE_TIMER_NAMES[timer] << "\":{\"calls\":"
+               << totalTimerCalls[timer] << ",\"seconds\":" << totalTimerNanoseconds[timer] * 1e-9 << "}";
+    }
+    stream << "}}";
+}
+
+ProfileScope::ProfileScope(ProfileTimer scopeTimer) : timer(scopeTimer),
+                                                      start(std::chrono::steady_clock::now())
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    Profile::forThread().time(timer, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+#endif
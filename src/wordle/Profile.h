@@ -0,0 +1,99 @@
+#ifndef WORDLE_PROFILE_H
+#define WORDLE_PROFILE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+// counters and phase timers for finding where turn time goes. they only
+// exist in builds with WORDLE_PROFILE defined; otherwise the macros below
+// compile to nothing.
+#ifdef WORDLE_PROFILE
+
+enum ProfileCounter
+{
+    PROFILE_FEEDBACK_COMPUTATIONS,
+    PROFILE_CONSISTENCY_CHECKS,
+    PROFILE_GUESSES_SCORED,
+    PROFILE_TRANSPOSITION_HITS,
+    PROFILE_TRANSPOSITION_MISSES,
+    PROFILE_TREE_HITS,
+    PROFILE_COUNTER_COUNT
+};
+
+enum ProfileTimer
+{
+    PROFILE_GET_GUESS,
+    PROFILE_FILTERING,
+    PROFILE_SCORING,
+    PROFILE_REDUCTION,
+    PROFILE_LOOKAHEAD,
+    PROFILE_TIMER_COUNT
+};
+
+// one per thread, so counting never contends. totals sum every live
+// thread's block plus what exited threads left behind.
+class Profile
+{
+public:
+    Profile();
+    ~Profile();
+
+    static Profile &forThread();
+    static void writeJson(std::ostream &stream);
+
+    void count(ProfileCounter counter, uint64_t amount);
+    void time(ProfileTimer timer, uint64_t nanoseconds);
+
+private:
+    static void add(uint64_t *totals, const std::atomic<uint64_t> *values, std::size_t count);
+
+    // written by the owning thread only, read by writeJson from any.
+    std::atomic<uint64_t> counters[PROFILE_COUNTER_COUNT];
+    std::atomic<uint64_t> timerCalls[PROFILE_TIMER_COUNT];
+    std::atomic<uint64_t> timerNanoseconds[PROFILE_TIMER_COUNT];
+
+    static std::mutex registryMutex;
+    static std::vector<Profile *> registry;
+    static uint64_t exitedCounters[PROFILE_COUNTER_COUNT];
+    static uint64_t exitedTimerCalls[PROFILE_TIMER_COUNT];
+    static uint64_t exitedTimerNanoseconds[PROFILE_TIMER_COUNT];
+};
+
+// adds the time until it goes out of scope to timer.
+class ProfileScope
+{
+public:
+    ProfileScope(ProfileTimer timer);
+    ~ProfileScope();
+
+private:
+    ProfileTimer timer;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define PROFILE_CONCATENATE(left, right) left##right
+
+#define PROFILE_SCOPE_NAME(line) PROFILE_CONCATENATE(profileScope, line)
+
+#define PROFILE_COUNT(counter, amount) Profile::forThread().count(counter, amount)
+
+#define PROFILE_SCOPE(timer) ProfileScope PROFILE_SCOPE_NAME(__LINE__)(timer)
+
+#else
+
+#define PROFILE_COUNT(counter, amount) \
+    do                                 \
+    {                                  \
+    } while (0)
+#define PROFILE_SCOPE(timer) \
+    do                       \
+    {                        \
+    } while (0)
+#endif
+
+#endif
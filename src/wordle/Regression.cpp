@@ -0,0 +1,365 @@
+#include "wordle/Regression.h"
+
+#include "wordle/Solver.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+
+// latency changes smaller than this are timer noise, however large a
+// fraction of a fast turn they are.
+#define REGRESSION_MIN_LATENCY_SECONDS 0.0005
+
+// starts a new peak resident set measurement, false where the kernel
+// doesn't support it.
+static bool resetPeakRss()
+{
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+    return static_cast<bool>(clearRefs);
+}
+
+static uint64_t readPeakRssBytes()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            return std::strtoull(line.c_str() + 6, NULL, 10) << 10;
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss) << 10;
+}
+
+static double readCpuSeconds()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+// the smallest value at least fraction of sortedValues are no more than.
+static double percentile(const std::vector<double> &sortedValues, double fraction)
+{
+    if (sortedValues.empty())
+    {
+        return 0;
+    }
+    std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * sortedValues.size()));
+    return sortedValues[std::max<std::size_t>(rank, 1) - 1];
+}
+
+template <std::size_t Length>
+RegressionResult runRegression(const WordleGame<Length> &prototype, WorkerPool &pool)
+{
+    auto answerWords = prototype.getAnswerWords();
+    std::vector<SolveResult> results(answerWords->size());
+    std::vector<std::vector<double> > workerTurnSeconds(pool.numWorkers());
+    resetPeakRss();
+    double cpuStart = readCpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(
+        answerWords->size(), 1,
+        [&](std::size_t worker, std::size_t begin, std::size_t end)
+        {
+            for (std::size_t answerIndex = begin; answerIndex < end; answerIndex++)
+            {
+                auto game = prototype.newGame();
+                results[answerIndex] = solveGame(*game, (*answerWords)[answerIndex], &workerTurnSeconds[worker]);
+            }
+        });
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    RegressionResult result;
+    result.configuration = prototype.configurationName();
+    result.numGames = static_cast<int32_t>(results.size());
+    result.wallSeconds = wallSeconds;
+    result.cpuSeconds = readCpuSeconds() - cpuStart;
+    result.gamesPerSecond = wallSeconds > 0 ? results.size() / wallSeconds : 0;
+    result.peakRssBytes = readPeakRssBytes();
+    result.worstGuesses = 0;
+    result.numFailures = 0;
+    int64_t totalGuesses = 0;
+    int32_t numSolved = 0;
+    for (const auto &solveResult : results)
+    {
+        result.worstGuesses = std::max(result.worstGuesses, solveResult.numGuesses);
+        if (!solveResult.solved || solveResult.numGuesses > WORDLE_TURN_LIMIT)
+        {
+            result.numFailures++;
+        }
+        if (solveResult.solved)
+        {
+            numSolved++;
+            totalGuesses += solveResult.numGuesses;
+        }
+    }
+    result.meanGuesses = numSolved > 0 ? static_cast<double>(totalGuesses) / numSolved : 0;
+    std::vector<double> turnSeconds;
+    for (const auto &seconds : workerTurnSeconds)
+    {
+        turnSeconds.insert(turnSeconds.end(), seconds.begin(), seconds.end());
+    }
+    std::sort(turnSeconds.begin(), turnSeconds.end());
+    result.p50TurnSeconds = percentile(turnSeconds, 0.5);
+    result.p99TurnSeconds = percentile(turnSeconds, 0.99);
+    return result;
+}
+
+void writeRegressionJson(std::ostream &stream, std::size_t wordLength, const std::vector<RegressionResult> &results)
+{
+    std::ostringstream json;
+    json << std::setprecision(9);
+    json << "{\"wordLength\":" << wordLength << ",\"configurations\":[";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const RegressionResult &result = results[i];
+        json << (i > 0 ? "," : "") << "\n{\"configuration\":\"" << result.configuration << "\""
+             << ",\"numGames\":" << result.numGames
+             << ",\"meanGuesses\":" << result.meanGuesses
+             << ",\"worstGuesses\":" << result.worstGuesses
+             << ",\"numFailures\":" << result.numFailures
+             << ",\"p50TurnSeconds\":" << result.p50TurnSeconds
+             << ",\"p99TurnSeconds\":" << result.p99TurnSeconds
+             << ",\"wallSeconds\":" << result.wallSeconds
+             << ",\"cpuSeconds\":" << result.cpuSeconds
+             << ",\"gamesPerSecond\":" << result.gamesPerSecond
+             << ",\"peakRssBytes\":" << result.peakRssBytes << "}";
+    }
+    json << "\n]}\n";
+    stream << json.str();
+}
+
+// just enough json for writeRegressionJson's output: objects, arrays,
+// strings without escapes and numbers.
+class RegressionJsonReader
+{
+public:
+    RegressionJsonReader(const std::string &jsonText) : text(jsonText), position(0)
+    {
+    }
+
+    std::vector<RegressionResult> readResults()
+    {
+        std::vector<RegressionResult> results;
+        expect('{');
+        while (!consume('}'))
+        {
+            std::string key = readKey();
+            if (key != "configurations")
+            {
+                readNumber();
+            }
+            else
+            {
+                expect('[');
+                while (!consume(']'))
+                {
+                    results.push_back(readResult());
+                    consume(',');
+                }
+            }
+            consume(',');
+        }
+        return results;
+    }
+
+private:
+    RegressionResult readResult()
+    {
+        RegressionResult result = RegressionResult();
+        expect('{');
+        while (!consume('}'))
+        {
+            std::string key = readKey();
+            if (key == "configuration")
+            {
+                result.configuration = readString();
+            }
+            else
+            {
+                double value = readNumber();
+                if (key == "numGames")
+                {
+                    result.numGames = static_cast<int32_t>(value);
+                }
+                else if (key == "meanGuesses")
+                {
+                    result.meanGuesses = value;
+                }
+                else if (key == "worstGuesses")
+                {
+                    result.worstGuesses = static_cast<int32_t>(value);
+                }
+                else if (key == "numFailures")
+                {
+                    result.numFailures = static_cast<int32_t>(value);
+                }
+                else if (key == "p50TurnSeconds")
+                {
+                    result.p50TurnSeconds = value;
+                }
+                else if (key == "p99TurnSeconds")
+                {
+                    result.p99TurnSeconds = value;
+                }
+                else if (key == "wallSeconds")
+                {
+                    result.wallSeconds = value;
+                }
+                else if (key == "cpuSeconds")
+                {
+                    result.cpuSeconds = value;
+                }
+                else if (key == "gamesPerSecond")
+                {
+                    result.gamesPerSecond = value;
+                }
+                else if (key == "peakRssBytes")
+                {
+                    result.peakRssBytes = static_cast<uint64_t>(value);
+                }
+            }
+            consume(',');
+        }
+        return result;
+    }
+    void skipSpace()
+    {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+        {
+            position++;
+        }
+    }
+    bool consume(char c)
+    {
+        skipSpace();
+        if (position < text.size() && text[position] == c)
+        {
+            position++;
+            return true;
+        }
+        return false;
+    }
+    void expect(char c)
+    {
+        if (!consume(c))
+        {
+            throw std::runtime_error(std::string("Regression results: expected '") + c + "'");
+        }
+    }
+    std::string readString()
+    {
+        expect('"');
+        std::size_t end = text.find('"', position);
+        if (end == std::string::npos)
+        {
+            throw std::runtime_error("Regression results: unterminated string");
+        }
+        std::string value = text.substr(position, end - position);
+        position = end + 1;
+        return value;
+    }
+    std::string readKey()
+    {
+        std::string key = readString();
+        expect(':');
+        return key;
+    }
+    double readNumber()
+    {
+        skipSpace();
+        const char *begin = text.c_str() + position;
+        char *end;
+        double value = std::strtod(begin, &end);
+        if (end == begin)
+        {
+            throw std::runtime_error("Regression results: expected a number");
+        }
+        position += end - begin;
+        return value;
+    }
+
+    const std::string &text;
+    std::size_t position;
+};
+
+std::vector<RegressionResult> readRegressionJson(std::istream &stream)
+{
+    std::ostringstream text;
+    text << stream.rdbuf();
+    std::string jsonText = text.str();
+    return RegressionJsonReader(jsonText).readResults();
+}
+
+std::vector<std::string> findRegressions(
+    const std::vector<RegressionResult> &baseline,
+    const std::vector<RegressionResult> &results,
+    double threshold)
+{
+    std::vector<std::string> regressions;
+    for (const auto &result : results)
+    {
+        auto found = std::find_if(
+            baseline.begin(), baseline.end(),
+            [&](const RegressionResult &expected)
+            {
+                return expected.configuration == result.configuration;
+            });
+        if (found == baseline.end())
+        {
+            continue;
+        }
+        const RegressionResult &expected = *found;
+        auto report = [&](const char *metric, double was, double now)
+        {
+            std::ostringstream line;
+            line << std::setprecision(6) << result.configuration << ": " << metric << " " << was << " -> " << now;
+            regressions.push_back(line.str());
+        };
+        if (result.meanGuesses > expected.meanGuesses + 1e-6)
+        {
+            report("mean guesses", expected.meanGuesses, result.meanGuesses);
+        }
+        if (result.worstGuesses > expected.worstGuesses)
+        {
+            report("worst guesses", expected.worstGuesses, result.worstGuesses);
+        }
+        if (result.numFailures > expected.numFailures)
+        {
+            report("failures", expected.numFailures, result.numFailures);
+        }
+        if (result.gamesPerSecond < expected.gamesPerSecond * (1 - threshold))
+        {
+            report("games per second", expected.gamesPerSecond, result.gamesPerSecond);
+        }
+        if (result.p50TurnSeconds > expected.p50TurnSeconds * (1 + threshold) &&
+            result.p50TurnSeconds - expected.p50TurnSeconds > REGRESSION_MIN_LATENCY_SECONDS)
+        {
+            report("p50 turn seconds", expected.p50TurnSeconds, result.p50TurnSeconds);
+        }
+        if (result.p99TurnSeconds > expected.p99TurnSeconds * (1 + threshold) &&
+            result.p99TurnSeconds - expected.p99TurnSeconds > REGRESSION_MIN_LATENCY_SECONDS)
+        {
+            report("p99 turn seconds", expected.p99TurnSeconds, result.p99TurnSeconds);
+        }
+    }
+    return regressions;
+}
+
+#define INSTANTIATE_REGRESSION(Length) \
+    template RegressionResult runRegression(const WordleGame<Length> &prototype, WorkerPool &pool);
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_REGRESSION)
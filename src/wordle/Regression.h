@@ -0,0 +1,55 @@
+#ifndef WORDLE_REGRESSION_H
+#define WORDLE_REGRESSION_H
+
+#include "wordle/WordleGame.h"
+#include "wordle/WorkerPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// end to end results of solving every answer with one configuration, the
+// unit the regression harness compares against a baseline.
+struct RegressionResult
+{
+    // WordleGame::configurationName, which results are matched up by.
+    std::string configuration;
+    int32_t numGames;
+    double meanGuesses;
+    int32_t worstGuesses;
+    int32_t numFailures;
+    // over every getGuess of every game.
+    double p50TurnSeconds;
+    double p99TurnSeconds;
+    double wallSeconds;
+    // user plus system time of the whole process, so every thread counts.
+    double cpuSeconds;
+    double gamesPerSecond;
+    // the process's peak resident set during the run, where the kernel lets
+    // it be reset, and since the process started otherwise.
+    uint64_t peakRssBytes;
+};
+
+// solves every answer in a newGame of prototype, the games in parallel on
+// pool.
+template <std::size_t Length>
+RegressionResult runRegression(const WordleGame<Length> &prototype, WorkerPool &pool);
+
+// results as json: the word length, then one object per configuration with
+// the fields of RegressionResult.
+void writeRegressionJson(std::ostream &stream, std::size_t wordLength, const std::vector<RegressionResult> &results);
+// the results in writeRegressionJson's output. throws std::runtime_error on
+// anything else.
+std::vector<RegressionResult> readRegressionJson(std::istream &stream);
+// one line for each way results are worse than the same configuration in
+// baseline: fewer games per second or slower turns by more than threshold,
+// a fraction, or any more guesses or failures, since those don't depend on
+// timing. configurations missing from either side are not compared.
+std::vector<std::string> findRegressions(
+    const std::vector<RegressionResult> &baseline,
+    const std::vector<RegressionResult> &results,
+    double threshold);
+
+#endif
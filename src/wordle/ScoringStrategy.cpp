@@ -0,0 +1,132 @@
+#include "wordle/ScoringStrategy.h"
+
+#include <algorithm>
+#include <cmath>
+
+ScoringStrategy::~ScoringStrategy()
+{
+}
+
+template <typename Strategy>
+double HistogramScoringStrategy<Strategy>::score(const uint16_t *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const
+{
+    return static_cast<const Strategy *>(this)->scoreCounts(feedbackIdCounts, numFeedbackIds, numCandidates);
+}
+
+template <typename Strategy>
+double HistogramScoringStrategy<Strategy>::score(const uint32_t *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const
+{
+    return static_cast<const Strategy *>(this)->scoreCounts(feedbackIdCounts, numFeedbackIds, numCandidates);
+}
+
+const char *ExpectedSizeStrategy::name() const
+{
+    return "expected";
+}
+
+template <typename Count>
+double ExpectedSizeStrategy::scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const
+{
+    int64_t sumOfSquares = 0;
+    for (std::size_t feedbackId = 0; feedbackId < numFeedbackIds; feedbackId++)
+    {
+        int32_t count = static_cast<int32_t>(feedbackIdCounts[feedbackId]);
+        sumOfSquares += static_cast<int64_t>(count) * count;
+    }
+    return static_cast<double>(sumOfSquares) / numCandidates;
+}
+
+EntropyStrategy::EntropyStrategy(int32_t maxCandidates) : countLog2Count(maxCandidates + 1, 0)
+{
+    for (int32_t count = 1; count <= maxCandidates; count++)
+    {
+        countLog2Count[count] = count * std::log2(static_cast<double>(count));
+    }
+}
+
+const char *EntropyStrategy::name() const
+{
+    return "entropy";
+}
+
+template <typename Count>
+double EntropyStrategy::scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const
+{
+    double sum = 0;
+    for (std::size_t feedbackId = 0; feedbackId < numFeedbackIds; feedbackId++)
+    {
+        int32_t count = static_cast<int32_t>(feedbackIdCounts[feedbackId]);
+        sum += countLog2Count[count];
+    }
+    return sum / numCandidates - countLog2Count[numCandidates] / numCandidates;
+}
+
+const char *MinimaxStrategy::name() const
+{
+    return "minimax";
+}
+
+template <typename Count>
+double MinimaxStrategy::scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t /*numCandidates*/) const
+{
+    int32_t largest = 0;
+    for (std::size_t feedbackId = 0; feedbackId < numFeedbackIds; feedbackId++)
+    {
+        int32_t count = static_cast<int32_t>(feedbackIdCounts[feedbackId]);
+        largest = std::max(largest, count);
+    }
+    return largest;
+}
+
+const char *MostPartsStrategy::name() const
+{
+    return "most-parts";
+}
+
+template <typename Count>
+double MostPartsStrategy::scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t /*numCandidates*/) const
+{
+    int32_t parts = 0;
+    for (std::size_t feedbackId = 0; feedbackId < numFeedbackIds; feedbackId++)
+    {
+        int32_t count = static_cast<int32_t>(feedbackIdCounts[feedbackId]);
+        parts += count > 0;
+    }
+    return -parts;
+}
+
+template class HistogramScoringStrategy<ExpectedSizeStrategy>;
+template class HistogramScoringStrategy<EntropyStrategy>;
+template class HistogramScoringStrategy<MinimaxStrategy>;
+template class HistogramScoringStrategy<MostPartsStrategy>;
+
+std::shared_ptr<const ScoringStrategy> createScoringStrategy(const std::string &name, int32_t maxCandidates)
+{
+    if (name == "expected")
+    {
+        return std::make_shared<ExpectedSizeStrategy>();
+    }
+    if (name == "entropy")
+    {
+        return std::make_shared<EntropyStrategy>(maxCandidates);
+    }
+    if (name == "minimax")
+    {
+        return std::make_shared<MinimaxStrategy>();
+    }
+    if (name == "most-parts")
+    {
+        return std::make_shared<MostPartsStrategy>();
+    }
+    return std::shared_ptr<const ScoringStrategy>();
+}
+
+std::vector<std::string> scoringStrategyNames()
+{
+    std::vector<std::string> names;
+    names.push_back("expected");
+    names.push_back("entropy");
+    names.push_back("minimax");
+    names.push_back("most-parts");
+    return names;
+}
@@ -0,0 +1,97 @@
+#ifndef WORDLE_SCORING_STRATEGY_H
+#define WORDLE_SCORING_STRATEGY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// judges a guess from the histogram of feedback ids it would split the
+// candidates into, so the strategy can be picked per deployment at run
+// time. lower scores are better. the histogram has one count per feedback
+// id, numFeedbackIds of them, which depends on the word length. counts are
+// 16 bits unless the candidate set is too large for that.
+class ScoringStrategy
+{
+public:
+    virtual ~ScoringStrategy();
+    virtual const char *name() const = 0;
+    virtual double score(const uint16_t *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const = 0;
+    virtual double score(const uint32_t *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const = 0;
+};
+
+// both score overloads for a Strategy that scores the counts in one
+// template, scoreCounts<Count>, so each strategy writes its loop once.
+template <typename Strategy>
+class HistogramScoringStrategy : public ScoringStrategy
+{
+public:
+    double score(const uint16_t *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const;
+    double score(const uint32_t *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const;
+};
+
+// expected number of candidates left after the guess, sum(c^2) / n.
+class ExpectedSizeStrategy : public HistogramScoringStrategy<ExpectedSizeStrategy>
+{
+public:
+    const char *name() const;
+
+private:
+    friend class HistogramScoringStrategy<ExpectedSizeStrategy>;
+
+    template <typename Count>
+    double scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const;
+};
+
+// negated shannon entropy of the split. with p = c / n the entropy is
+// log2(n) - sum(c * log2(c)) / n, so the per-bin work is one lookup in a
+// table of c * log2(c) and an add, with no branches or calls to log.
+class EntropyStrategy : public HistogramScoringStrategy<EntropyStrategy>
+{
+public:
+    EntropyStrategy(int32_t maxCandidates);
+    const char *name() const;
+
+private:
+    friend class HistogramScoringStrategy<EntropyStrategy>;
+
+    template <typename Count>
+    double scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const;
+
+    std::vector<double> countLog2Count;
+};
+
+// size of the largest bucket, the worst case after the guess.
+class MinimaxStrategy : public HistogramScoringStrategy<MinimaxStrategy>
+{
+public:
+    const char *name() const;
+
+private:
+    friend class HistogramScoringStrategy<MinimaxStrategy>;
+
+    template <typename Count>
+    double scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const;
+};
+
+// number of distinct feedbacks the guess can produce, negated.
+class MostPartsStrategy : public HistogramScoringStrategy<MostPartsStrategy>
+{
+public:
+    const char *name() const;
+
+private:
+    friend class HistogramScoringStrategy<MostPartsStrategy>;
+
+    template <typename Count>
+    double scoreCounts(const Count *feedbackIdCounts, std::size_t numFeedbackIds, int32_t numCandidates) const;
+};
+
+// maxCandidates bounds the candidate counts the strategy will be asked to
+// score. returns NULL for an unknown name.
+std::shared_ptr<const ScoringStrategy> createScoringStrategy(const std::string &name, int32_t maxCandidates);
+// every name createScoringStrategy knows.
+std::vector<std::string> scoringStrategyNames();
+
+#endif
@@ -0,0 +1,571 @@
+#include "wordle/Server.h"
+
+#ifdef WORDLE_SERVER
+#include "wordle/Profile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// written by SIGINT and SIGTERM to stop SolverServer::run.
+static int serverStopFd = -1;
+
+static void stopServer(int)
+{
+    uint64_t one = 1;
+    ssize_t written = write(serverStopFd, &one, sizeof(one));
+    (void)written;
+}
+
+// input a client may queue up before it is disconnected.
+#define SERVER_MAX_INPUT_BYTES 65536
+
+template <std::size_t Length>
+SolverServer<Length>::SolverServer(const WordleGame<Length> &prototypeGame, std::size_t numThreads) : prototype(prototypeGame),
+                                                                                       pool(new WorkerPool(numThreads + 1)),
+                                                                                       searchDeadline(0),
+                                                                                       listenFd(-1)
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    searchDoneFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || searchDoneFd < 0 || stopFd < 0)
+    {
+        throw std::runtime_error("Unable to create server event loop");
+    }
+    watch(searchDoneFd, EPOLLIN, EPOLL_CTL_ADD);
+    watch(stopFd, EPOLLIN, EPOLL_CTL_ADD);
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::setSearchDeadline(std::chrono::milliseconds deadline)
+{
+    searchDeadline = deadline;
+}
+
+template <std::size_t Length>
+SolverServer<Length>::~SolverServer()
+{
+    // let running searches finish before the descriptor they signal goes.
+    pool.reset();
+    for (auto &entry : sessions)
+    {
+        close(entry.first);
+    }
+    if (listenFd >= 0)
+    {
+        close(listenFd);
+    }
+    if (!unixPath.empty())
+    {
+        unlink(unixPath.c_str());
+    }
+    serverStopFd = -1;
+    close(stopFd);
+    close(searchDoneFd);
+    close(epollFd);
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::watch(int fd, uint32_t events, int operation)
+{
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, operation, fd, &event) != 0)
+    {
+        throw std::runtime_error("Unable to watch socket");
+    }
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::listen(const std::string &address)
+{
+    if (address.compare(0, 5, "unix:") == 0)
+    {
+        sockaddr_un unixAddress;
+        std::memset(&unixAddress, 0, sizeof(unixAddress));
+        unixAddress.sun_family = AF_UNIX;
+        std::string path = address.substr(5);
+        if (path.empty() || path.size() >= sizeof(unixAddress.sun_path))
+        {
+            throw std::runtime_error("Invalid socket path " + path);
+        }
+        std::memcpy(unixAddress.sun_path, path.c_str(), path.size());
+        // a socket left behind by an earlier server.
+        unlink(path.c_str());
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&unixAddress), sizeof(unixAddress)) != 0)
+        {
+            throw std::runtime_error("Unable to bind " + address);
+        }
+        unixPath = path;
+    }
+    else if (address.compare(0, 4, "tcp:") == 0)
+    {
+        std::string hostPort = address.substr(4);
+        std::string host = "127.0.0.1";
+        std::string port = hostPort;
+        std::size_t separator = hostPort.rfind(':');
+        if (separator != std::string::npos)
+        {
+            host = hostPort.substr(0, separator);
+            port = hostPort.substr(separator + 1);
+        }
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo *addresses = NULL;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0 || !addresses)
+        {
+            throw std::runtime_error("Unable to resolve " + address);
+        }
+        listenFd = socket(addresses->ai_family, addresses->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addresses->ai_protocol);
+        int reuse = 1;
+        bool bound = listenFd >= 0 &&
+                     setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == 0 &&
+                     bind(listenFd, addresses->ai_addr, addresses->ai_addrlen) == 0;
+        freeaddrinfo(addresses);
+        if (!bound)
+        {
+            throw std::runtime_error("Unable to bind " + address);
+        }
+    }
+    else
+    {
+        throw std::runtime_error("Invalid server address " + address);
+    }
+    if (::listen(listenFd, SOMAXCONN) != 0)
+    {
+        throw std::runtime_error("Unable to listen on " + address);
+    }
+    watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::run()
+{
+    serverStopFd = stopFd;
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    std::vector<epoll_event> events(64);
+    while (true)
+    {
+        int numEvents = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), -1);
+        if (numEvents < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("Server event loop failed");
+        }
+        for (int32_t i = 0; i < numEvents; i++)
+        {
+            int fd = events[i].data.fd;
+            if (fd == stopFd)
+            {
+                signal(SIGINT, SIG_DFL);
+                signal(SIGTERM, SIG_DFL);
+                return;
+            }
+            if (fd == listenFd)
+            {
+                acceptConnections();
+                continue;
+            }
+            if (fd == searchDoneFd)
+            {
+                finishSearches();
+                continue;
+            }
+            // an earlier event in this batch may have closed it.
+            auto found = sessions.find(fd);
+            if (found == sessions.end())
+            {
+                continue;
+            }
+            std::shared_ptr<Session> session = found->second;
+            if (events[i].events & EPOLLOUT)
+            {
+                writeSession(session);
+            }
+            if (!session->closed && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+            {
+                readSession(session);
+            }
+        }
+        startSearches();
+    }
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::acceptConnections()
+{
+    while (true)
+    {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            // EAGAIN once the backlog is empty; anything else is the
+            // client's problem, not the server's.
+            return;
+        }
+        std::shared_ptr<Session> session = std::make_shared<Session>();
+        session->fd = fd;
+        session->game = prototype.newGame();
+        session->searching = false;
+        session->inputEnded = false;
+        session->closed = false;
+        session->cancelled = false;
+        sessions[fd] = session;
+        watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+    }
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::readSession(const std::shared_ptr<Session> &session)
+{
+    if (session->inputEnded)
+    {
+        // only hangups are watched for by now: the client is gone.
+        closeSession(session);
+        return;
+    }
+    char buffer[4096];
+    while (true)
+    {
+        ssize_t numRead = read(session->fd, buffer, sizeof(buffer));
+        if (numRead > 0)
+        {
+            session->input.append(buffer, numRead);
+            continue;
+        }
+        if (numRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        if (numRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (numRead == 0)
+        {
+            // commands already sent still get their replies.
+            session->inputEnded = true;
+            break;
+        }
+        // a broken connection.
+        closeSession(session);
+        return;
+    }
+    if (session->input.size() > SERVER_MAX_INPUT_BYTES)
+    {
+        closeSession(session);
+        return;
+    }
+    runCommands(session);
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::runCommands(const std::shared_ptr<Session> &session)
+{
+    while (!session->closed && !session->searching)
+    {
+        std::size_t lineEnd = session->input.find('\n');
+        if (lineEnd == std::string::npos)
+        {
+            break;
+        }
+        std::string line = session->input.substr(0, lineEnd);
+        session->input.erase(0, lineEnd + 1);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        runCommand(session, line);
+    }
+    if (!session->closed)
+    {
+        writeSession(session);
+    }
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::runCommand(const std::shared_ptr<Session> &session, const std::string &line)
+{
+    std::istringstream words(line);
+    std::string command;
+    words >> command;
+    WordleGame<Length> &game = *session->game;
+    try
+    {
+        if (command == "GUESS")
+        {
+            startSearch(session);
+            return;
+        }
+        if (command == "FEEDBACK")
+        {
+            std::string guess;
+            std::string feedback;
+            if (!(words >> guess >> feedback))
+            {
+                throw std::runtime_error("FEEDBACK needs a guess and its feedback");
+            }
+            game.pushFeedback(GuessFeedback<Length>(guess, feedback));
+        }
+        else if (command == "UNDO")
+        {
+            if (game.numFeedbacks() == 0)
+            {
+                throw std::runtime_error("No feedback to undo");
+            }
+            game.popFeedback();
+        }
+        else if (command == "RESET")
+        {
+            game.restart();
+        }
+        else if (command == "CANDIDATES")
+        {
+            auto possibleAnswers = game.getPossibleAnswers();
+            std::string reply = "CANDIDATES " + std::to_string(possibleAnswers.size());
+            for (const auto &possibleAnswer : possibleAnswers)
+            {
+                reply += " " + possibleAnswer.toString();
+            }
+            session->output += reply + "\n";
+            return;
+        }
+        else if (command == "STATS")
+        {
+#ifdef WORDLE_PROFILE
+            std::ostringstream stats;
+            Profile::writeJson(stats);
+            session->output += "STATS " + stats.str() + "\n";
+            return;
+#else
+            throw std::runtime_error("Profiling is not compiled in");
+#endif
+        }
+        else if (command == "QUIT")
+        {
+            // flush what is queued, then hang up.
+            writeSession(session);
+            closeSession(session);
+            return;
+        }
+        else
+        {
+            throw std::runtime_error("Unknown command " + command);
+        }
+        session->output += "OK " + std::to_string(session->game->getPossibleAnswers().size()) + "\n";
+    }
+    catch (const std::runtime_error &error)
+    {
+        session->output += std::string("ERROR ") + error.what() + "\n";
+    }
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::startSearch(const std::shared_ptr<Session> &session)
+{
+    // held until the events from this wakeup are handled, so sessions that
+    // ask at about the same time are searched together.
+    session->searching = true;
+    session->searchStart = std::chrono::steady_clock::now();
+    pendingSearches.push_back(session);
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::startSearches()
+{
+    if (pendingSearches.empty())
+    {
+        return;
+    }
+    if (searchDeadline.count() > 0)
+    {
+        for (const auto &session : pendingSearches)
+        {
+            submitTimedSearch(session);
+        }
+        pendingSearches.clear();
+        return;
+    }
+    // one batch per searching thread, each scored in one pass over the
+    // guesses.
+    std::size_t numBatches = std::min(pendingSearches.size(), std::max<std::size_t>(pool->numWorkers() - 1, 1));
+    for (std::size_t batch = 0; batch < numBatches; batch++)
+    {
+        std::vector<std::shared_ptr<Session> > batchSessions;
+        for (std::size_t i = batch; i < pendingSearches.size(); i += numBatches)
+        {
+            batchSessions.push_back(pendingSearches[i]);
+        }
+        submitBatch(batchSessions);
+    }
+    pendingSearches.clear();
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::submitBatch(const std::vector<std::shared_ptr<Session> > &batchSessions)
+{
+    pool->submit(
+        [this, batchSessions]()
+        {
+            std::vector<WordleGame<Length> *> games;
+            for (const auto &session : batchSessions)
+            {
+                games.push_back(session->game.get());
+            }
+            std::vector<CompletedSearch> done;
+            try
+            {
+                std::vector<Word<Length> > guesses;
+                WordleGame<Length>::getGuesses(games, guesses, NULL);
+                for (std::size_t i = 0; i < batchSessions.size(); i++)
+                {
+                    CompletedSearch search = {batchSessions[i], "GUESS " + guesses[i].toString() + "\n"};
+                    done.push_back(search);
+                }
+            }
+            catch (const std::runtime_error &error)
+            {
+                done.clear();
+                for (const auto &session : batchSessions)
+                {
+                    CompletedSearch search = {session, std::string("ERROR ") + error.what() + "\n"};
+                    done.push_back(search);
+                }
+            }
+            completeSearches(done);
+        });
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::submitTimedSearch(const std::shared_ptr<Session> &session)
+{
+    pool->submit(
+        [this, session]()
+        {
+            CompletedSearch done = {session, ""};
+            try
+            {
+                SearchLimit limit(session->searchStart + searchDeadline, &session->cancelled);
+                GuessResult<Length> result = session->game->getGuessWithin(limit);
+                done.reply = "GUESS " + result.guess.toString() + (result.complete ? "\n" : " PARTIAL\n");
+            }
+            catch (const std::runtime_error &error)
+            {
+                done.reply = std::string("ERROR ") + error.what() + "\n";
+            }
+            completeSearches(std::vector<CompletedSearch>(1, done));
+        });
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::completeSearches(const std::vector<CompletedSearch> &done)
+{
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completed.insert(completed.end(), done.begin(), done.end());
+    }
+    uint64_t one = 1;
+    ssize_t written = write(searchDoneFd, &one, sizeof(one));
+    (void)written;
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::finishSearches()
+{
+    uint64_t count;
+    ssize_t numRead = read(searchDoneFd, &count, sizeof(count));
+    (void)numRead;
+    std::vector<CompletedSearch> done;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        done.swap(completed);
+    }
+    for (auto &search : done)
+    {
+        search.session->searching = false;
+        if (search.session->closed)
+        {
+            continue;
+        }
+        search.session->output += search.reply;
+        // commands that arrived during the search.
+        runCommands(search.session);
+    }
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::writeSession(const std::shared_ptr<Session> &session)
+{
+    while (!session->output.empty())
+    {
+        ssize_t numWritten = send(session->fd, session->output.data(), session->output.size(), MSG_NOSIGNAL);
+        if (numWritten > 0)
+        {
+            session->output.erase(0, numWritten);
+            continue;
+        }
+        if (numWritten < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (numWritten < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            // finish when the client has read some of it.
+            watch(session->fd, (session->inputEnded ? 0 : EPOLLIN) | EPOLLOUT, EPOLL_CTL_MOD);
+            return;
+        }
+        closeSession(session);
+        return;
+    }
+    if (session->inputEnded && !session->searching)
+    {
+        // every command before the end of input has been answered.
+        closeSession(session);
+        return;
+    }
+    // an ended input stays readable forever, so it is no longer watched.
+    watch(session->fd, session->inputEnded ? 0 : EPOLLIN, EPOLL_CTL_MOD);
+}
+
+template <std::size_t Length>
+void SolverServer<Length>::closeSession(const std::shared_ptr<Session> &session)
+{
+    if (session->closed)
+    {
+        return;
+    }
+    // a search still running keeps the session alive and is dropped when
+    // it completes.
+    session->closed = true;
+    session->cancelled = true;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+    close(session->fd);
+    sessions.erase(session->fd);
+}
+
+#define INSTANTIATE_SOLVER_SERVER(Length) template class SolverServer<Length>;
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_SOLVER_SERVER)
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef WORDLE_SERVER_H
+#define WORDLE_SERVER_H
+
+#include "wordle/WordleGame.h"
+#include "wordle/WorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#define WORDLE_SERVER 1
+#endif
+
+#ifdef WORDLE_SERVER
+
+// serves many games from one process over a unix or tcp socket. every
+// connection is one game sharing the prototype's word lists, matrix and
+// caches, with one command per line:
+//   GUESS                     -> GUESS <word>
+//   FEEDBACK <guess> <rygs>   -> OK <candidates left>
+//   UNDO                      -> OK <candidates left>
+//   RESET                     -> OK <candidates left>
+//   CANDIDATES                -> CANDIDATES <count> <word>...
+//   STATS                     -> STATS <profile json>, profiling builds
+//   QUIT                      closes the connection
+// failures get ERROR <reason>. replies come in command order; lines sent
+// while a guess is being searched for wait their turn. GUESS commands that
+// arrive together are searched in batches. with a search deadline each
+// GUESS is searched on its own and answered by the deadline, as
+// GUESS <word> PARTIAL when the search had to stop early.
+template <std::size_t Length>
+class SolverServer
+{
+public:
+    // searches on numThreads threads of its own, never on the event loop.
+    SolverServer(const WordleGame<Length> &prototype, std::size_t numThreads);
+    ~SolverServer();
+
+    // time from reading GUESS to replying; 0, the default, waits for
+    // complete searches.
+    void setSearchDeadline(std::chrono::milliseconds deadline);
+    // unix:<path> or tcp:[<host>:]<port>, host defaulting to loopback.
+    void listen(const std::string &address);
+    // until SIGINT or SIGTERM.
+    void run();
+
+private:
+    struct Session
+    {
+        int fd;
+        std::unique_ptr<WordleGame<Length> > game;
+        std::string input;
+        std::string output;
+        // a guess search for this session is on the pool, and the game
+        // must not be touched until it finishes.
+        bool searching;
+        // the client shut down its side; the session closes once the
+        // commands it sent before that are answered.
+        bool inputEnded;
+        bool closed;
+        std::chrono::steady_clock::time_point searchStart;
+        // set on close to stop a search nobody will read.
+        std::atomic<bool> cancelled;
+    };
+    struct CompletedSearch
+    {
+        std::shared_ptr<Session> session;
+        std::string reply;
+    };
+
+    void acceptConnections();
+    void readSession(const std::shared_ptr<Session> &session);
+    void runCommands(const std::shared_ptr<Session> &session);
+    void runCommand(const std::shared_ptr<Session> &session, const std::string &line);
+    void startSearch(const std::shared_ptr<Session> &session);
+    // hands the searches started since the last call to the pool in
+    // batches, see WordleGame::getGuesses.
+    void startSearches();
+    void submitBatch(const std::vector<std::shared_ptr<Session> > &batchSessions);
+    void submitTimedSearch(const std::shared_ptr<Session> &session);
+    void completeSearches(const std::vector<CompletedSearch> &done);
+    void finishSearches();
+    void writeSession(const std::shared_ptr<Session> &session);
+    void closeSession(const std::shared_ptr<Session> &session);
+    void watch(int fd, uint32_t events, int operation);
+
+    const WordleGame<Length> &prototype;
+    std::unique_ptr<WorkerPool> pool;
+    std::chrono::milliseconds searchDeadline;
+    int listenFd;
+    int epollFd;
+    // written by the pool each time a search completes.
+    int searchDoneFd;
+    int stopFd;
+    std::string unixPath;
+    std::unordered_map<int, std::shared_ptr<Session> > sessions;
+    std::mutex completedMutex;
+    std::vector<CompletedSearch> completed;
+    std::vector<std::shared_ptr<Session> > pendingSearches;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+#include "wordle/Solver.h"
+
+#include <chrono>
+#include <unordered_map>
+
+// a node of a decision tree under construction, before it is laid out
+// breadth first.
+template <std::size_t Length>
+struct DecisionTreeBuildNode
+{
+    uint32_t guessIndex;
+    FeedbackCell<Length> feedbackId;
+    std::vector<std::unique_ptr<DecisionTreeBuildNode> > children;
+};
+
+// records the guess game makes now, then recurses into every feedback that
+// guess can get from the remaining candidates.
+template <std::size_t Length>
+std::unique_ptr<DecisionTreeBuildNode<Length> > buildDecisionSubtree(
+    WordleGame<Length> &game,
+    const std::unordered_map<PackedLetterCodes<Length>, uint32_t> &guessIndices,
+    FeedbackCell<Length> feedbackId,
+    std::size_t numTurns)
+{
+    std::unique_ptr<DecisionTreeBuildNode<Length> > node(new DecisionTreeBuildNode<Length>);
+    Word<Length> guess = game.getGuess();
+    auto found = guessIndices.find(guess.packedLetterCodes());
+    if (found == guessIndices.end())
+    {
+        throw std::runtime_error("Guess " + guess.toString() + " is not in the guess list");
+    }
+    node->guessIndex = found->second;
+    node->feedbackId = feedbackId;
+    if (game.numFeedbacks() + 1 >= numTurns)
+    {
+        return node;
+    }
+
+    std::vector<bool> seenFeedbackIds(maxFeedbackId(Length) + 1, false);
+    for (const auto &possibleAnswer : game.getPossibleAnswers())
+    {
+        seenFeedbackIds[WordleGame<Length>::computeFeedbackId(guess, possibleAnswer)] = true;
+    }
+    for (int32_t childFeedbackId = 0; childFeedbackId < maxFeedbackId(Length); childFeedbackId++)
+    {
+        // maxFeedbackId itself means the guess was right and ends the game.
+        if (!seenFeedbackIds[childFeedbackId])
+        {
+            continue;
+        }
+        game.pushFeedback(GuessFeedback<Length>(guess, childFeedbackId));
+        node->children.push_back(buildDecisionSubtree(game, guessIndices, childFeedbackId, numTurns));
+        game.popFeedback();
+    }
+    return node;
+}
+
+template <std::size_t Length>
+std::shared_ptr<const DecisionTree<Length> > buildDecisionTree(
+    const WordleGame<Length> &prototype,
+    WorkerPool &pool,
+    std::size_t numTurns)
+{
+    auto guessWords = prototype.getGuessWords();
+    std::unordered_map<PackedLetterCodes<Length>, uint32_t> guessIndices;
+    for (std::size_t guessIndex = 0; guessIndex < guessWords->size(); guessIndex++)
+    {
+        guessIndices.insert(std::make_pair((*guessWords)[guessIndex].packedLetterCodes(), static_cast<uint32_t>(guessIndex)));
+    }
+
+    auto game = prototype.newGame();
+    game->setDecisionTree(std::shared_ptr<const DecisionTree<Length> >());
+    std::unique_ptr<DecisionTreeBuildNode<Length> > root(new DecisionTreeBuildNode<Length>);
+    Word<Length> firstGuess = game->getGuess();
+    root->guessIndex = guessIndices.at(firstGuess.packedLetterCodes());
+    root->feedbackId = 0;
+    // the first guess's children are the second turn.
+    std::vector<int32_t> firstFeedbackIds;
+    std::vector<bool> seenFeedbackIds(maxFeedbackId(Length) + 1, false);
+    for (const auto &answer : *prototype.getAnswerWords())
+    {
+        seenFeedbackIds[WordleGame<Length>::computeFeedbackId(firstGuess, answer)] = true;
+    }
+    for (int32_t feedbackId = 0; feedbackId < maxFeedbackId(Length) && numTurns > 1; feedbackId++)
+    {
+        if (seenFeedbackIds[feedbackId])
+        {
+            firstFeedbackIds.push_back(feedbackId);
+        }
+    }
+    root->children.resize(firstFeedbackIds.size());
+    pool.parallelFor(
+        firstFeedbackIds.size(), 1,
+        [&](std::size_t, std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                auto branchGame = prototype.newGame();
+                branchGame->setDecisionTree(std::shared_ptr<const DecisionTree<Length> >());
+                branchGame->pushFeedback(GuessFeedback<Length>(firstGuess, firstFeedbackIds[i]));
+                root->children[i] = buildDecisionSubtree(*branchGame, guessIndices, firstFeedbackIds[i], numTurns);
+            }
+        });
+
+    std::vector<uint32_t> firstChildren;
+    std::vector<uint32_t> treeGuessIndices;
+    std::vector<FeedbackCell<Length> > treeFeedbackIds;
+    std::vector<const DecisionTreeBuildNode<Length> *> queue;
+    queue.push_back(root.get());
+    for (std::size_t next = 0; next < queue.size(); next++)
+    {
+        const DecisionTreeBuildNode<Length> *node = queue[next];
+        firstChildren.push_back(static_cast<uint32_t>(queue.size()));
+        treeGuessIndices.push_back(node->guessIndex);
+        treeFeedbackIds.push_back(node->feedbackId);
+        for (const auto &child : node->children)
+        {
+            queue.push_back(child.get());
+        }
+    }
+    firstChildren.push_back(static_cast<uint32_t>(queue.size()));
+    return std::make_shared<DecisionTree<Length> >(firstChildren, treeGuessIndices, treeFeedbackIds);
+}
+
+template <std::size_t Length>
+SolveResult solveGame(WordleGame<Length> &game, const Word<Length> &solution, std::vector<double> *turnSeconds)
+{
+    auto start = std::chrono::steady_clock::now();
+    SolveResult result = {0, false, 0};
+    while (result.numGuesses < MAX_GUESSES)
+    {
+        auto turnStart = std::chrono::steady_clock::now();
+        Word<Length> guess = game.getGuess();
+        if (turnSeconds)
+        {
+            turnSeconds->push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - turnStart).count());
+        }
+        result.numGuesses++;
+        if (guess == solution)
+        {
+            result.solved = true;
+            break;
+        }
+        game.pushFeedback(WordleGame<Length>::computeFeedback(guess, solution));
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+template <std::size_t Length>
+std::vector<SolveResult> solveGames(
+    const std::vector<WordleGame<Length> *> &games,
+    const std::vector<Word<Length> > &solutions,
+    WorkerPool *pool)
+{
+    SolveResult unplayed = {0, false, 0};
+    std::vector<SolveResult> results(games.size(), unplayed);
+    // positions of the games still playing.
+    std::vector<std::size_t> playing;
+    for (std::size_t i = 0; i < games.size(); i++)
+    {
+        playing.push_back(i);
+    }
+    std::vector<WordleGame<Length> *> turnGames;
+    std::vector<Word<Length> > guesses;
+    while (!playing.empty())
+    {
+        auto start = std::chrono::steady_clock::now();
+        turnGames.clear();
+        for (auto i : playing)
+        {
+            turnGames.push_back(games[i]);
+        }
+        WordleGame<Length>::getGuesses(turnGames, guesses, pool);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::size_t numPlaying = 0;
+        for (std::size_t k = 0; k < playing.size(); k++)
+        {
+            std::size_t i = playing[k];
+            SolveResult &result = results[i];
+            result.numGuesses++;
+            result.seconds += seconds;
+            if (guesses[k] == solutions[i])
+            {
+                result.solved = true;
+                continue;
+            }
+            if (result.numGuesses < MAX_GUESSES)
+            {
+                games[i]->pushFeedback(WordleGame<Length>::computeFeedback(guesses[k], solutions[i]));
+                playing[numPlaying++] = i;
+            }
+        }
+        playing.resize(numPlaying);
+    }
+    return results;
+}
+
+#define INSTANTIATE_SOLVER(Length) \
+    template std::shared_ptr<const DecisionTree<Length> > buildDecisionTree( \
+        const WordleGame<Length> &prototype, WorkerPool &pool, std::size_t numTurns); \
+    template SolveResult solveGame( \
+        WordleGame<Length> &game, const Word<Length> &solution, std::vector<double> *turnSeconds); \
+    template std::vector<SolveResult> solveGames( \
+        const std::vector<WordleGame<Length> *> &games, \
+        const std::vector<Word<Length> > &solutions, \
+        WorkerPool *pool);
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_SOLVER)
@@ -0,0 +1,42 @@
+#ifndef WORDLE_SOLVER_H
+#define WORDLE_SOLVER_H
+
+#include "wordle/DecisionTree.h"
+#include "wordle/WordleGame.h"
+#include "wordle/WorkerPool.h"
+
+#include <memory>
+#include <vector>
+
+struct SolveResult
+{
+    int32_t numGuesses;
+    bool solved;
+    double seconds;
+};
+
+// plays game against a known solution, scoring its guesses with
+// computeFeedback the way a player would. the time of each getGuess is
+// appended to turnSeconds unless it is NULL.
+template <std::size_t Length>
+SolveResult solveGame(WordleGame<Length> &game, const Word<Length> &solution, std::vector<double> *turnSeconds);
+
+// solveGame for many games at once, with one getGuesses call per turn for
+// all the games not yet solved. a game's seconds are the time of the
+// batched turns it took part in.
+template <std::size_t Length>
+std::vector<SolveResult> solveGames(
+    const std::vector<WordleGame<Length> *> &games,
+    const std::vector<Word<Length> > &solutions,
+    WorkerPool *pool);
+
+// walks every game the solver can play from the start and records its
+// guesses for the first numTurns turns, MAX_GUESSES for whole games. the
+// subtrees under the first guess are built in parallel.
+template <std::size_t Length>
+std::shared_ptr<const DecisionTree<Length> > buildDecisionTree(
+    const WordleGame<Length> &prototype,
+    WorkerPool &pool,
+    std::size_t numTurns);
+
+#endif
@@ -0,0 +1,210 @@
+#include "wordle/TranspositionCache.h"
+
+#include "wordle/FeedbackMatrix.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#define TRANSPOSITION_CACHE_MAGIC "WRDLTTAB"
+
+#define TRANSPOSITION_CACHE_VERSION 1
+
+#define TRANSPOSITION_CACHE_SHARDS 16
+
+struct TranspositionCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t wordLength;
+    uint64_t sourceChecksum;
+    uint64_t guessCount;
+    uint64_t entryCount;
+};
+
+struct TranspositionCacheRecord
+{
+    uint64_t high;
+    uint64_t low;
+    uint32_t guessIndex;
+    uint32_t reserved;
+    double score;
+};
+
+bool TranspositionCache::Key::operator==(const Key &other) const
+{
+    return high == other.high && low == other.low;
+}
+
+std::size_t TranspositionCache::KeyHash::operator()(const Key &key) const
+{
+    return static_cast<std::size_t>(key.low);
+}
+
+TranspositionCache::TranspositionCache(std::size_t capacity) : shards(TRANSPOSITION_CACHE_SHARDS),
+                                                                  hits(0),
+                                                                  misses(0)
+{
+    std::size_t slotsPerShard = std::max<std::size_t>(1, capacity / TRANSPOSITION_CACHE_SHARDS);
+    for (auto &shard : shards)
+    {
+        shard.slots.resize(slotsPerShard);
+        shard.slotIndices.reserve(slotsPerShard);
+        shard.hand = 0;
+    }
+}
+
+TranspositionCache::~TranspositionCache()
+{
+}
+
+TranspositionCache::Shard &TranspositionCache::shardFor(const Key &key)
+{
+    return shards[key.high % shards.size()];
+}
+
+bool TranspositionCache::lookup(const Key &key, Entry &entry)
+{
+    Shard &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.slotIndices.find(key);
+    if (found == shard.slotIndices.end())
+    {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Slot &slot = shard.slots[found->second];
+    slot.referenced = true;
+    entry = slot.entry;
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void TranspositionCache::insert(const Key &key, const Entry &entry)
+{
+    Shard &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.slotIndices.find(key);
+    if (found != shard.slotIndices.end())
+    {
+        shard.slots[found->second].entry = entry;
+        return;
+    }
+    while (shard.slots[shard.hand].used && shard.slots[shard.hand].referenced)
+    {
+        shard.slots[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+    }
+    Slot &slot = shard.slots[shard.hand];
+    if (slot.used)
+    {
+        // reuse the evicted entry's map node, so a full cache stops
+        // allocating.
+        auto node = shard.slotIndices.extract(slot.key);
+        node.key() = key;
+        shard.slotIndices.insert(std::move(node));
+    }
+    else
+    {
+        shard.slotIndices[key] = shard.hand;
+    }
+    slot.key = key;
+    slot.entry = entry;
+    slot.used = true;
+    slot.referenced = false;
+    shard.hand = (shard.hand + 1) % shard.slots.size();
+}
+
+uint64_t TranspositionCache::numHits() const
+{
+    return hits.load(std::memory_order_relaxed);
+}
+
+uint64_t TranspositionCache::numMisses() const
+{
+    return misses.load(std::memory_order_relaxed);
+}
+
+bool TranspositionCache::load(const std::string &path, uint64_t sourceChecksum, std::size_t wordLength, std::size_t guessCount)
+{
+    std::shared_ptr<MappedFile> file;
+    try
+    {
+        file = std::make_shared<MappedFile>(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        return false;
+    }
+    TranspositionCacheHeader header;
+    if (file->size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, TRANSPOSITION_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRANSPOSITION_CACHE_VERSION ||
+        header.wordLength != wordLength ||
+        header.sourceChecksum != sourceChecksum ||
+        header.guessCount != guessCount ||
+        header.entryCount > (file->size() - sizeof(header)) / sizeof(TranspositionCacheRecord))
+    {
+        return false;
+    }
+    for (uint64_t i = 0; i < header.entryCount; i++)
+    {
+        TranspositionCacheRecord record;
+        std::memcpy(&record, file->data() + sizeof(header) + i * sizeof(record), sizeof(record));
+        if (record.guessIndex >= guessCount)
+        {
+            continue;
+        }
+        Key key = {record.high, record.low};
+        Entry entry = {record.guessIndex, record.score};
+        insert(key, entry);
+    }
+    return true;
+}
+
+void TranspositionCache::save(const std::string &path, uint64_t sourceChecksum, std::size_t wordLength, std::size_t guessCount) const
+{
+    std::vector<TranspositionCacheRecord> records;
+    for (const auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto &slot : shard.slots)
+        {
+            if (slot.used)
+            {
+                TranspositionCacheRecord record = {slot.key.high, slot.key.low, slot.entry.guessIndex, 0, slot.entry.score};
+                records.push_back(record);
+            }
+        }
+    }
+
+    TranspositionCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TRANSPOSITION_CACHE_MAGIC, sizeof(header.magic));
+    header.version = TRANSPOSITION_CACHE_VERSION;
+    header.wordLength = wordLength;
+    header.sourceChecksum = sourceChecksum;
+    header.guessCount = guessCount;
+    header.entryCount = records.size();
+
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        throw std::runtime_error("Unable to write " + temporaryPath);
+    }
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(TranspositionCacheRecord));
+    stream.close();
+    if (!stream || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Unable to write " + path);
+    }
+}
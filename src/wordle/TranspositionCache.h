@@ -0,0 +1,73 @@
+#ifndef WORDLE_TRANSPOSITION_CACHE_H
+#define WORDLE_TRANSPOSITION_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// best guesses already found for candidate sets, keyed by a 128-bit hash of
+// the set and the solver configuration. different feedback histories often
+// leave the same candidates, so one cache is shared by every game in the
+// process. each shard is a fixed array of slots with CLOCK eviction: a hit
+// marks its slot, and the hand skips (and unmarks) marked slots when it
+// looks for one to reuse.
+class TranspositionCache
+{
+public:
+    struct Key
+    {
+        uint64_t high;
+        uint64_t low;
+        bool operator==(const Key &other) const;
+    };
+    struct Entry
+    {
+        uint32_t guessIndex;
+        double score;
+    };
+
+    TranspositionCache(std::size_t capacity);
+    ~TranspositionCache();
+
+    bool lookup(const Key &key, Entry &entry);
+    void insert(const Key &key, const Entry &entry);
+    uint64_t numHits() const;
+    uint64_t numMisses() const;
+    // persistence in the same style as the dictionary cache: a header that
+    // ties the entries to the word lists they were found for. load returns
+    // false when the file is missing or does not match.
+    bool load(const std::string &path, uint64_t sourceChecksum, std::size_t wordLength, std::size_t guessCount);
+    void save(const std::string &path, uint64_t sourceChecksum, std::size_t wordLength, std::size_t guessCount) const;
+
+private:
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const;
+    };
+    struct Slot
+    {
+        Key key;
+        Entry entry;
+        bool used;
+        bool referenced;
+    };
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, std::size_t, KeyHash> slotIndices;
+        std::vector<Slot> slots;
+        std::size_t hand;
+    };
+
+    Shard &shardFor(const Key &key);
+
+    std::vector<Shard> shards;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "wordle/Word.h"
+
+#include <stdexcept>
+
+ssize_t indexForLetter(Letter letter)
+{
+    if (!('a' <= letter && letter <= 'z'))
+    {
+        std::cerr << "Invalid letter " << std::hex << static_cast<int>(letter) << std::endl;
+        throw std::runtime_error("Invalid letter");
+    }
+    return static_cast<ssize_t>(letter - 'a');
+}
+
+template <std::size_t Length>
+const std::size_t Word<Length>::LENGTH;
+
+template <std::size_t Length>
+Word<Length>::Word(std::string wordString) : letterCodes(0), presentLetters(0)
+{
+    if (wordString.size() != Length)
+    {
+        throw std::runtime_error("Invalid word length");
+    }
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        PackedLetterCodes<Length> code = static_cast<PackedLetterCodes<Length> >(indexForLetter(wordString[i]));
+        letterCodes |= code << (LETTER_CODE_BITS * i);
+        presentLetters |= 1u << code;
+    }
+}
+
+template <std::size_t Length>
+Word<Length> Word<Length>::fromLetterCodes(PackedLetterCodes<Length> packedCodes)
+{
+    std::string wordString(Length, 'a');
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        uint32_t code = (packedCodes >> (LETTER_CODE_BITS * i)) & LETTER_CODE_MASK;
+        if (code >= NUMBER_OF_LETTERS)
+        {
+            throw std::runtime_error("Invalid letter code");
+        }
+        wordString[i] = static_cast<char>('a' + code);
+    }
+    return Word(wordString);
+}
+
+template <std::size_t Length>
+std::string Word<Length>::toString() const
+{
+    // short enough for the small string buffer, so this never allocates.
+    char letters[Length];
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        letters[i] = (*this)[i];
+    }
+    return std::string(letters, Length);
+}
+
+template <std::size_t Length>
+bool Word<Length>::containsLetter(Letter letter) const
+{
+    return (presentLetters >> indexForLetter(letter)) & 1;
+}
+
+template <std::size_t Length>
+Letter Word<Length>::operator[](std::size_t index) const
+{
+    return static_cast<Letter>('a' + letterCode(index));
+}
+
+template <std::size_t Length>
+uint8_t Word<Length>::letterCode(std::size_t index) const
+{
+    return (letterCodes >> (LETTER_CODE_BITS * index)) & LETTER_CODE_MASK;
+}
+
+template <std::size_t Length>
+PackedLetterCodes<Length> Word<Length>::packedLetterCodes() const
+{
+    return letterCodes;
+}
+
+template <std::size_t Length>
+uint32_t Word<Length>::letterMask() const
+{
+    return presentLetters;
+}
+
+template <std::size_t Length>
+bool Word<Length>::operator==(const Word &other) const
+{
+    return letterCodes == other.letterCodes;
+}
+
+template <std::size_t Length>
+bool Word<Length>::operator!=(const Word &other) const
+{
+    return letterCodes != other.letterCodes;
+}
+
+template <std::size_t Length>
+std::ostream &operator<<(std::ostream &stream, const Word<Length> &word)
+{
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        stream << word[i];
+    }
+    return stream;
+}
+
+#define INSTANTIATE_WORD(Length) \
+    template class Word<Length>; \
+    template std::ostream &operator<<(std::ostream &stream, const Word<Length> &word);
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_WORD)
@@ -0,0 +1,80 @@
+#ifndef WORDLE_WORD_H
+#define WORDLE_WORD_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <sys/types.h>
+
+#define NUMBER_OF_LETTERS 26
+
+// the word lengths one binary supports. every length template is
+// instantiated once per length, and the front end picks the instantiation
+// matching the dictionary it loads.
+#define MIN_WORD_LENGTH 4
+
+#define MAX_WORD_LENGTH 7
+
+#define WORDLE_FOR_EACH_WORD_LENGTH(MACRO) \
+    MACRO(4)                               \
+    MACRO(5)                               \
+    MACRO(6)                               \
+    MACRO(7)
+
+#define MAX_GUESSES 10
+
+// games that need more guesses than the real game allows count as failures.
+#define WORDLE_TURN_LIMIT 6
+
+typedef char Letter;
+
+ssize_t indexForLetter(Letter letter);
+
+#define LETTER_CODE_BITS 5
+
+#define LETTER_CODE_MASK ((1u << LETTER_CODE_BITS) - 1)
+
+// the letter codes of a Length-letter word, packed LETTER_CODE_BITS each.
+template <std::size_t Length>
+using PackedLetterCodes = typename std::conditional<(Length * LETTER_CODE_BITS <= 32), uint32_t, uint64_t>::type;
+
+// a word packed into two integers: the letter codes (0 for 'a' up to 25 for
+// 'z') five bits per position, and a mask with one bit per letter the word
+// contains. it is trivially copyable and 8 bytes up to six letters, so
+// passing it by value is as cheap as passing a pointer and whole word lists
+// stay in cache.
+template <std::size_t Length>
+class Word
+{
+public:
+    static const std::size_t LENGTH = Length;
+
+    Word(std::string wordString);
+    static Word fromLetterCodes(PackedLetterCodes<Length> packedCodes);
+    bool containsLetter(const Letter letter) const;
+    Letter operator[](std::size_t index) const;
+    uint8_t letterCode(std::size_t index) const;
+    PackedLetterCodes<Length> packedLetterCodes() const;
+    uint32_t letterMask() const;
+    bool operator==(const Word &other) const;
+    bool operator!=(const Word &other) const;
+    std::string toString() const;
+
+private:
+    PackedLetterCodes<Length> letterCodes;
+    uint32_t presentLetters;
+};
+
+static_assert(MAX_WORD_LENGTH * LETTER_CODE_BITS <= 64, "letter codes must fit in 64 bits");
+
+static_assert(NUMBER_OF_LETTERS <= 32, "letter mask must fit in 32 bits");
+
+static_assert(sizeof(Word<6>) == 8, "words up to six letters are 8 bytes");
+
+static_assert(std::is_trivially_copyable<Word<MAX_WORD_LENGTH> >::value, "words are copied by value in hot loops");
+
+template <std::size_t Length>
+std::ostream &operator<<(std::ostream &stream, const Word<Length> &word);
+
+#endif
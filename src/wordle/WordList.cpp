@@ -0,0 +1,44 @@
+#include "wordle/WordList.h"
+
+#include <sstream>
+
+template <std::size_t Length>
+std::unique_ptr<std::vector<Word<Length> > > readFileLines(std::istream &stream)
+{
+    std::unique_ptr<std::vector<Word<Length> > > lines(new std::vector<Word<Length> >);
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        lines->push_back(Word<Length>(line));
+    }
+
+    return lines;
+}
+
+std::size_t firstWordLength(const std::string &text)
+{
+    return text.find_first_of("\r\n") == std::string::npos ? text.size() : text.find_first_of("\r\n");
+}
+
+std::string readFileBytes(std::istream &stream)
+{
+    std::stringstream bytes;
+    bytes << stream.rdbuf();
+    return bytes.str();
+}
+
+uint64_t checksumBytes(const std::string &bytes, uint64_t checksum)
+{
+    for (auto byte : bytes)
+    {
+        checksum ^= static_cast<uint8_t>(byte);
+        checksum *= 1099511628211ull;
+    }
+    return checksum;
+}
+
+#define INSTANTIATE_WORD_LIST(Length) \
+    template std::unique_ptr<std::vector<Word<Length> > > readFileLines<Length>(std::istream &stream);
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_WORD_LIST)
@@ -0,0 +1,26 @@
+#ifndef WORDLE_WORD_LIST_H
+#define WORDLE_WORD_LIST_H
+
+#include "wordle/Word.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// one word per line.
+template <std::size_t Length>
+std::unique_ptr<std::vector<Word<Length> > > readFileLines(std::istream &stream);
+
+// the length of the first word in a word list file, which decides the word
+// length the dictionary is played at. 0 when there are no words.
+std::size_t firstWordLength(const std::string &text);
+
+// the whole stream as one string.
+std::string readFileBytes(std::istream &stream);
+
+// FNV-1a, continued from a previous call's result.
+uint64_t checksumBytes(const std::string &bytes, uint64_t checksum = 14695981039346656037ull);
+
+#endif
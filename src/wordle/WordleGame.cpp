@@ -0,0 +1,1203 @@
+#include "wordle/WordleGame.h"
+
+#include "wordle/Profile.h"
+#include "wordle/WordList.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+
+// guesses scored between checks for a search limit, and handed to workers
+// at a time.
+#define GUESS_CHUNK_SIZE 64
+
+// a lower bound on the expected number of guesses, this one included, to
+// find one of numCandidates equally likely answers. a turn splits the
+// candidates into at most maxFeedbackId(Length) open buckets, so at most
+// maxFeedbackId(Length)^(k-1) answers can be found on guess k.
+template <std::size_t Length>
+double minimumExpectedGuesses(std::size_t numCandidates)
+{
+    double remaining = static_cast<double>(numCandidates);
+    double totalGuesses = 0;
+    double capacity = 1;
+    for (int32_t guess = 1; remaining > 0; guess++)
+    {
+        double found = std::min(remaining, capacity);
+        totalGuesses += found * guess;
+        remaining -= found;
+        capacity *= maxFeedbackId(Length);
+    }
+    return totalGuesses / numCandidates;
+}
+
+template <std::size_t Length>
+WordleGame<Length>::WordleGame(
+    std::unique_ptr<std::vector<Word<Length> > > guessWordList,
+    std::unique_ptr<std::vector<Word<Length> > > answerWordList) : guessWords(appendAnswers(std::move(guessWordList), *answerWordList)),
+                                                          answerWords(std::move(answerWordList)),
+                                                          scoringStrategy(std::make_shared<ExpectedSizeStrategy>()),
+                                                          searchDepth(1),
+                                                          searchBreadth(16),
+                                                          guessPrefilterSize(0),
+                                                          hardMode(false),
+                                                          searchLimit(NULL),
+                                                          searchStopped(false)
+{
+    updateConfigurationHash();
+    resetCandidates();
+}
+
+template <std::size_t Length>
+WordleGame<Length>::WordleGame(
+    std::shared_ptr<const std::vector<Word<Length> > > guessWordList,
+    std::shared_ptr<const std::vector<Word<Length> > > answerWordList) : guessWords(guessWordList),
+                                                                answerWords(answerWordList),
+                                                                searchDepth(1),
+                                                                searchBreadth(16),
+                                                                guessPrefilterSize(0),
+                                                                hardMode(false),
+                                                                configurationHash(0),
+                                                                searchLimit(NULL),
+                                                                searchStopped(false)
+{
+    resetCandidates();
+}
+
+template <std::size_t Length>
+std::shared_ptr<const std::vector<Word<Length> > > WordleGame<Length>::appendAnswers(
+    std::unique_ptr<std::vector<Word<Length> > > guessWordList,
+    const std::vector<Word<Length> > &answerWordList)
+{
+    // answers that are already guesses would only be scored twice.
+    std::vector<PackedLetterCodes<Length> > knownLetterCodes;
+    knownLetterCodes.reserve(guessWordList->size() + answerWordList.size());
+    for (const auto &guess : *guessWordList)
+    {
+        knownLetterCodes.push_back(guess.packedLetterCodes());
+    }
+    std::sort(knownLetterCodes.begin(), knownLetterCodes.end());
+    for (const auto &answer : answerWordList)
+    {
+        auto position = std::lower_bound(knownLetterCodes.begin(), knownLetterCodes.end(), answer.packedLetterCodes());
+        if (position == knownLetterCodes.end() || *position != answer.packedLetterCodes())
+        {
+            knownLetterCodes.insert(position, answer.packedLetterCodes());
+            guessWordList->push_back(answer);
+        }
+    }
+    return std::shared_ptr<const std::vector<Word<Length> > >(std::move(guessWordList));
+}
+
+template <std::size_t Length>
+std::unique_ptr<WordleGame<Length> > WordleGame<Length>::newGame() const
+{
+    std::unique_ptr<WordleGame<Length> > game(new WordleGame<Length>(guessWords, answerWords));
+    game->feedbackMatrix = feedbackMatrix;
+    game->feedbackBlocks = feedbackBlocks;
+    game->scoringStrategy = scoringStrategy;
+    game->searchDepth = searchDepth;
+    game->searchBreadth = searchBreadth;
+    game->guessPrefilterSize = guessPrefilterSize;
+    game->hardMode = hardMode;
+    game->configurationHash = configurationHash;
+    game->setDecisionTree(decisionTree);
+    game->transpositionCache = transpositionCache;
+    return game;
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::resetCandidates()
+{
+    feedbacks.clear();
+    feedbacks.reserve(MAX_GUESSES);
+    constraints = FeedbackConstraints<Length>();
+    constraintHistory.clear();
+    constraintHistory.reserve(MAX_GUESSES);
+    candidateHistory.reserve(MAX_GUESSES);
+    spareCandidateSets.reserve(MAX_GUESSES);
+    candidates.reserve(answerWords->size());
+    for (std::size_t answerIndex = 0; answerIndex < answerWords->size(); answerIndex++)
+    {
+        candidates.push_back(static_cast<uint32_t>(answerIndex));
+    }
+    packedCandidates.assign(*answerWords, candidates);
+    resetGuessPool();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::resetGuessPool()
+{
+    guessPool.resize(guessWords->size());
+    for (std::size_t guessIndex = 0; guessIndex < guessWords->size(); guessIndex++)
+    {
+        guessPool[guessIndex] = static_cast<uint32_t>(guessIndex);
+    }
+    guessPoolHistory.clear();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::filterHardModeGuesses(
+    const std::vector<Word<Length> > &guessWords,
+    const GuessFeedback<Length> &guessFeedback,
+    const std::vector<uint32_t> &guessIndices,
+    std::vector<uint32_t> &result)
+{
+    FeedbackConstraints<Length> hints = FeedbackConstraints<Length>::revealedHints(guessFeedback);
+    result.clear();
+    for (auto guessIndex : guessIndices)
+    {
+        if (hints.allows(guessWords[guessIndex]))
+        {
+            result.push_back(guessIndex);
+        }
+    }
+}
+
+template <std::size_t Length>
+WordleGame<Length>::~WordleGame()
+{
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::enableFeedbackMatrix()
+{
+    feedbackMatrix = std::make_shared<FeedbackMatrix<Length> >(*guessWords, *answerWords);
+    feedbackBlocks.reset();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::enableFeedbackBlocks(std::size_t maxBytes)
+{
+    feedbackBlocks = std::make_shared<FeedbackBlockCache<Length> >(guessWords, answerWords, maxBytes);
+    feedbackMatrix.reset();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setFeedbackMatrix(std::shared_ptr<const FeedbackMatrix<Length> > matrix)
+{
+    if (matrix->numGuesses() != guessWords->size() || matrix->numAnswers() != answerWords->size())
+    {
+        throw std::runtime_error("Feedback matrix does not match word lists");
+    }
+    feedbackMatrix = matrix;
+    feedbackBlocks.reset();
+}
+
+template <std::size_t Length>
+std::shared_ptr<const FeedbackMatrix<Length> > WordleGame<Length>::getFeedbackMatrix() const
+{
+    return feedbackMatrix;
+}
+
+template <std::size_t Length>
+std::shared_ptr<FeedbackBlockCache<Length> > WordleGame<Length>::getFeedbackBlocks() const
+{
+    return feedbackBlocks;
+}
+
+template <std::size_t Length>
+int32_t WordleGame<Length>::numAnswers() const
+{
+    return static_cast<int32_t>(answerWords->size());
+}
+
+template <std::size_t Length>
+std::shared_ptr<const std::vector<Word<Length> > > WordleGame<Length>::getAnswerWords() const
+{
+    return answerWords;
+}
+
+template <std::size_t Length>
+std::vector<Word<Length> > WordleGame<Length>::getPossibleAnswers() const
+{
+    std::vector<Word<Length> > possibleAnswers;
+    possibleAnswers.reserve(candidates.size());
+    for (auto answerIndex : candidates)
+    {
+        possibleAnswers.push_back((*answerWords)[answerIndex]);
+    }
+    return possibleAnswers;
+}
+
+template <std::size_t Length>
+std::size_t WordleGame<Length>::numFeedbacks() const
+{
+    return feedbacks.size();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setWorkerPool(std::shared_ptr<WorkerPool> pool)
+{
+    workerPool = pool;
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setScoringStrategy(std::shared_ptr<const ScoringStrategy> strategy)
+{
+    scoringStrategy = strategy;
+    updateConfigurationHash();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setDecisionTree(std::shared_ptr<const DecisionTree<Length> > tree)
+{
+    decisionTree = tree;
+    treeNodes.clear();
+    if (!decisionTree)
+    {
+        return;
+    }
+    treeNodes.reserve(MAX_GUESSES + 1);
+    treeNodes.push_back(decisionTree->root());
+    for (const auto &guessFeedback : feedbacks)
+    {
+        treeNodes.push_back(nextTreeNode(guessFeedback));
+    }
+}
+
+template <std::size_t Length>
+int32_t WordleGame<Length>::nextTreeNode(const GuessFeedback<Length> &guessFeedback) const
+{
+    int32_t node = treeNodes.back();
+    if (node == DecisionTree<Length>::NO_NODE || (*guessWords)[decisionTree->guessIndex(node)] != guessFeedback.guess)
+    {
+        return DecisionTree<Length>::NO_NODE;
+    }
+    return decisionTree->child(node, guessFeedback.feedbackId());
+}
+
+template <std::size_t Length>
+std::string WordleGame<Length>::configurationName() const
+{
+    std::string name = scoringStrategy->name();
+    if (searchDepth > 1)
+    {
+        name += "/depth" + std::to_string(searchDepth) + "x" + std::to_string(searchBreadth);
+    }
+    if (guessPrefilterSize > 0)
+    {
+        name += "/top" + std::to_string(guessPrefilterSize);
+    }
+    if (hardMode)
+    {
+        name += "/hard";
+    }
+    return name;
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setSearchDepth(int32_t depth, int32_t breadth)
+{
+    searchDepth = depth;
+    searchBreadth = breadth;
+    updateConfigurationHash();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setGuessPrefilter(std::size_t size)
+{
+    guessPrefilterSize = size;
+    updateConfigurationHash();
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setHardMode(bool enabled)
+{
+    hardMode = enabled;
+    updateConfigurationHash();
+    resetGuessPool();
+    if (!hardMode)
+    {
+        return;
+    }
+    for (const auto &guessFeedback : feedbacks)
+    {
+        guessPoolHistory.push_back(guessPool);
+        filterHardModeGuesses(*guessWords, guessFeedback, guessPoolHistory.back(), guessPool);
+    }
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::updateConfigurationHash()
+{
+    configurationHash = checksumBytes(configurationName());
+}
+
+template <std::size_t Length>
+std::shared_ptr<const std::vector<Word<Length> > > WordleGame<Length>::getGuessWords() const
+{
+    return guessWords;
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::setTranspositionCache(std::shared_ptr<TranspositionCache> cache)
+{
+    transpositionCache = cache;
+}
+
+template <std::size_t Length>
+TranspositionCache::Key WordleGame<Length>::candidateSetKey() const
+{
+    // two independent 64-bit hashes over the (sorted) candidate indices,
+    // both seeded with the configuration so strategies never share entries.
+    TranspositionCache::Key key = {configurationHash ^ 0x9e3779b97f4a7c15ull, configurationHash};
+    for (auto answerIndex : candidates)
+    {
+        key.high = (key.high ^ answerIndex) * 0xff51afd7ed558ccdull;
+        key.high ^= key.high >> 33;
+        key.low = (key.low + answerIndex + 0x632be59bd9b4e019ull) * 0xc4ceb9fe1a85ec53ull;
+        key.low ^= key.low >> 29;
+    }
+    key.low ^= candidates.size();
+    if (hardMode)
+    {
+        // hard mode histories with the same candidates can still differ in
+        // the guesses left to pick from.
+        for (auto guessIndex : guessPool)
+        {
+            key.high = (key.high ^ guessIndex) * 0xff51afd7ed558ccdull;
+            key.high ^= key.high >> 33;
+            key.low = (key.low + guessIndex + 0x2545f4914f6cdd1dull) * 0xc4ceb9fe1a85ec53ull;
+            key.low ^= key.low >> 29;
+        }
+        key.high ^= guessPool.size();
+    }
+    return key;
+}
+
+template <std::size_t Length>
+int32_t WordleGame<Length>::computeFeedbackId(const Word<Length> &guess, const Word<Length> &solution)
+{
+    Feedback codes[Length];
+    computeFeedbackCodes(guess, solution, codes);
+    return feedbackIdFromCodes<Length>(codes);
+}
+
+template <std::size_t Length>
+GuessFeedback<Length> WordleGame<Length>::computeFeedback(const Word<Length> &guess, const Word<Length> &solution)
+{
+    return GuessFeedback<Length>(guess, computeFeedbackId(guess, solution));
+}
+
+template <std::size_t Length>
+Word<Length> WordleGame<Length>::getGuess()
+{
+    return searchGuess().guess;
+}
+
+template <std::size_t Length>
+GuessResult<Length> WordleGame<Length>::getGuessWithin(const SearchLimit &limit)
+{
+    searchLimit = &limit;
+    try
+    {
+        GuessResult<Length> result = searchGuess();
+        searchLimit = NULL;
+        return result;
+    }
+    catch (...)
+    {
+        searchLimit = NULL;
+        throw;
+    }
+}
+
+template <std::size_t Length>
+GuessResult<Length> WordleGame<Length>::searchGuess()
+{
+    PROFILE_SCOPE(PROFILE_GET_GUESS);
+    GuessResult<Length> result = {(*guessWords)[0], true};
+    TranspositionCache::Key cacheKey;
+    if (findKnownGuess(result.guess, cacheKey))
+    {
+        return result;
+    }
+    searchStopped = false;
+    double bestScore = std::numeric_limits<double>::infinity();
+    std::size_t bestGuessIndex = searchDepth > 1 ? searchBestGuess(bestScore) : findBestGuess(bestScore);
+    result.guess = (*guessWords)[bestGuessIndex];
+    result.complete = !searchStopped;
+    if (result.complete)
+    {
+        rememberGuess(cacheKey, bestGuessIndex, bestScore);
+    }
+    return result;
+}
+
+template <std::size_t Length>
+bool WordleGame<Length>::searchExpired() const
+{
+    if (!searchLimit)
+    {
+        return false;
+    }
+    if (searchStopped.load(std::memory_order_relaxed) || searchLimit->expired())
+    {
+        searchStopped = true;
+        return true;
+    }
+    return false;
+}
+
+template <std::size_t Length>
+bool WordleGame<Length>::findKnownGuess(Word<Length> &guess, TranspositionCache::Key &cacheKey) const
+{
+    if (!treeNodes.empty() && treeNodes.back() != DecisionTree<Length>::NO_NODE)
+    {
+        PROFILE_COUNT(PROFILE_TREE_HITS, 1);
+        guess = (*guessWords)[decisionTree->guessIndex(treeNodes.back())];
+        return true;
+    }
+    if (feedbacks.size() == 0 && Length == 5)
+    {
+        // pre-computed known best first guess for five letters.
+        guess = Word<Length>("roate");
+        return true;
+    }
+    int32_t numPossibleSolutions = static_cast<int32_t>(candidates.size());
+    if (numPossibleSolutions > 0 && numPossibleSolutions <= 2)
+    {
+        guess = (*answerWords)[candidates[0]];
+        return true;
+    }
+    if (transpositionCache)
+    {
+        TranspositionCache::Entry cached;
+        cacheKey = candidateSetKey();
+        if (transpositionCache->lookup(cacheKey, cached))
+        {
+            PROFILE_COUNT(PROFILE_TRANSPOSITION_HITS, 1);
+            guess = (*guessWords)[cached.guessIndex];
+            return true;
+        }
+        PROFILE_COUNT(PROFILE_TRANSPOSITION_MISSES, 1);
+    }
+    return false;
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::rememberGuess(const TranspositionCache::Key &cacheKey, std::size_t guessIndex, double score) const
+{
+    if (transpositionCache)
+    {
+        TranspositionCache::Entry entry = {static_cast<uint32_t>(guessIndex), score};
+        transpositionCache->insert(cacheKey, entry);
+    }
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::getGuesses(
+    const std::vector<WordleGame<Length> *> &games,
+    std::vector<Word<Length> > &guesses,
+    WorkerPool *pool)
+{
+    PROFILE_SCOPE(PROFILE_GET_GUESS);
+    guesses.clear();
+    guesses.reserve(games.size());
+    std::vector<TranspositionCache::Key> cacheKeys(games.size());
+    // positions in games of the ones left to score at depth 1, and their
+    // shortlists, NULL for games scoring every guess.
+    std::vector<std::size_t> batch;
+    std::vector<const std::vector<std::size_t> *> shortlists;
+    for (std::size_t i = 0; i < games.size(); i++)
+    {
+        WordleGame<Length> &game = *games[i];
+        guesses.push_back((*game.guessWords)[0]);
+        if (game.findKnownGuess(guesses[i], cacheKeys[i]))
+        {
+            continue;
+        }
+        if (game.searchDepth > 1)
+        {
+            double bestCost;
+            std::size_t bestGuessIndex = game.searchBestGuess(bestCost);
+            game.rememberGuess(cacheKeys[i], bestGuessIndex, bestCost);
+            guesses[i] = (*game.guessWords)[bestGuessIndex];
+            continue;
+        }
+        batch.push_back(i);
+        shortlists.push_back(NULL);
+        if (game.guessPool.size() < game.guessWords->size() ||
+            (game.guessPrefilterSize > 0 && game.guessPrefilterSize < game.guessPool.size()))
+        {
+            game.prefilterGuesses(game.candidates, game.guessPool, game.searchScratch.shortlist, game.searchScratch.coverage);
+            shortlists.back() = &game.searchScratch.shortlist;
+        }
+    }
+    if (batch.empty())
+    {
+        return;
+    }
+
+    // every worker walks its own range of guess indices and scores each
+    // guess for every game whose shortlist has it before moving on, so a
+    // matrix row is fetched once for the whole batch.
+    std::size_t numGuesses = games[batch[0]]->guessWords->size();
+    std::size_t numWorkers = pool ? pool->numWorkers() : 1;
+    std::vector<ScoringScratch> workerScratch(numWorkers);
+    std::vector<std::vector<std::size_t> > workerCursors(numWorkers, std::vector<std::size_t>(batch.size()));
+    std::vector<double> workerBestScores(numWorkers * batch.size(), std::numeric_limits<double>::infinity());
+    std::vector<std::size_t> workerBestGuessIndices(numWorkers * batch.size(), 0);
+    auto scoreGuesses = [&](std::size_t worker, std::size_t begin, std::size_t end)
+    {
+        std::vector<std::size_t> &cursors = workerCursors[worker];
+        for (std::size_t k = 0; k < batch.size(); k++)
+        {
+            if (shortlists[k])
+            {
+                cursors[k] = std::lower_bound(shortlists[k]->begin(), shortlists[k]->end(), begin) - shortlists[k]->begin();
+            }
+        }
+        for (std::size_t guessIndex = begin; guessIndex < end; guessIndex++)
+        {
+            for (std::size_t k = 0; k < batch.size(); k++)
+            {
+                const WordleGame<Length> &game = *games[batch[k]];
+                const std::vector<std::size_t> *shortlist = shortlists[k];
+                if (shortlist)
+                {
+                    if (cursors[k] == shortlist->size() || (*shortlist)[cursors[k]] != guessIndex)
+                    {
+                        continue;
+                    }
+                    cursors[k]++;
+                }
+                double score = game.scoreGuess(guessIndex, workerScratch[worker]);
+                std::size_t best = worker * batch.size() + k;
+                if (score < workerBestScores[best])
+                {
+                    workerBestScores[best] = score;
+                    workerBestGuessIndices[best] = guessIndex;
+                }
+            }
+        }
+    };
+    {
+        PROFILE_SCOPE(PROFILE_SCORING);
+        if (pool)
+        {
+            pool->parallelFor(numGuesses, GUESS_CHUNK_SIZE, scoreGuesses);
+        }
+        else
+        {
+            scoreGuesses(0, 0, numGuesses);
+        }
+    }
+
+    PROFILE_SCOPE(PROFILE_REDUCTION);
+    for (std::size_t k = 0; k < batch.size(); k++)
+    {
+        WordleGame<Length> &game = *games[batch[k]];
+        double bestScore = std::numeric_limits<double>::infinity();
+        std::size_t bestGuessIndex = 0;
+        for (std::size_t worker = 0; worker < numWorkers; worker++)
+        {
+            double score = workerBestScores[worker * batch.size() + k];
+            std::size_t guessIndex = workerBestGuessIndices[worker * batch.size() + k];
+            if (score < bestScore || (score == bestScore && guessIndex < bestGuessIndex))
+            {
+                bestScore = score;
+                bestGuessIndex = guessIndex;
+            }
+        }
+        game.rememberGuess(cacheKeys[batch[k]], bestGuessIndex, bestScore);
+        guesses[batch[k]] = (*game.guessWords)[bestGuessIndex];
+    }
+}
+
+template <std::size_t Length>
+std::size_t WordleGame<Length>::findBestGuess(double &bestScore)
+{
+    bestScore = std::numeric_limits<double>::infinity();
+    std::size_t bestGuessIndex = 0;
+    // one best (score, index) per worker, ties going to the lower index so
+    // the result matches scoring the guesses in order on one thread.
+    std::size_t numWorkers = workerPool ? workerPool->numWorkers() : 1;
+    std::vector<double> &workerBestScore = searchScratch.workerBestScores;
+    std::vector<std::size_t> &workerBestGuessIndex = searchScratch.workerBestGuessIndices;
+    std::vector<ScoringScratch> &workerScratch = searchScratch.workers;
+    std::vector<std::size_t> &shortlist = searchScratch.shortlist;
+    workerBestScore.assign(numWorkers, std::numeric_limits<double>::infinity());
+    workerBestGuessIndex.assign(numWorkers, 0);
+    workerScratch.resize(numWorkers);
+    prefilterGuesses(candidates, guessPool, shortlist, searchScratch.coverage);
+    if (searchLimit)
+    {
+        prioritizeGuesses(shortlist, searchScratch.coverage);
+    }
+    // capturing only this keeps the lambda small enough for std::function
+    // to hold without allocating.
+    auto scoreGuesses = [this](std::size_t worker, std::size_t begin, std::size_t end)
+    {
+        // the first chunk always runs, so there is a best guess to return.
+        if (begin > 0 && searchExpired())
+        {
+            return;
+        }
+        ScoringScratch &scratch = searchScratch.workers[worker];
+        for (std::size_t i = begin; i < end; i++)
+        {
+            std::size_t guessIndex = searchScratch.shortlist[i];
+            double score = scoreGuess(guessIndex, scratch);
+            double &workerBest = searchScratch.workerBestScores[worker];
+            if (score < workerBest || (score == workerBest && guessIndex < searchScratch.workerBestGuessIndices[worker]))
+            {
+                searchScratch.workerBestScores[worker] = score;
+                searchScratch.workerBestGuessIndices[worker] = guessIndex;
+            }
+        }
+    };
+    {
+        PROFILE_SCOPE(PROFILE_SCORING);
+        if (workerPool)
+        {
+            workerPool->parallelFor(shortlist.size(), GUESS_CHUNK_SIZE, scoreGuesses);
+        }
+        else
+        {
+            for (std::size_t begin = 0; begin < shortlist.size(); begin += GUESS_CHUNK_SIZE)
+            {
+                scoreGuesses(0, begin, std::min<std::size_t>(begin + GUESS_CHUNK_SIZE, shortlist.size()));
+            }
+        }
+    }
+    // blocks held between turns would count against no cache's limit.
+    for (auto &scratch : workerScratch)
+    {
+        scratch.releaseFeedbackBlock();
+    }
+
+    PROFILE_SCOPE(PROFILE_REDUCTION);
+    for (std::size_t worker = 0; worker < numWorkers; worker++)
+    {
+        double score = workerBestScore[worker];
+        if (score < bestScore || (score == bestScore && workerBestGuessIndex[worker] < bestGuessIndex))
+        {
+            bestScore = score;
+            bestGuessIndex = workerBestGuessIndex[worker];
+        }
+    }
+    return bestGuessIndex;
+}
+
+template <std::size_t Length>
+double WordleGame<Length>::scoreGuess(std::size_t guessIndex, ScoringScratch &scratch) const
+{
+    PROFILE_COUNT(PROFILE_GUESSES_SCORED, 1);
+    if (candidates.size() > UINT16_MAX)
+    {
+        return scoreGuessWith(guessIndex, scratch.wideFeedbackIdCounts, scratch);
+    }
+    return scoreGuessWith(guessIndex, scratch.feedbackIdCounts, scratch);
+}
+
+template <std::size_t Length>
+bool WordleGame<Length>::heldFeedbackBlock(std::size_t guessIndex, ScoringScratch &scratch) const
+{
+    // guesses are mostly scored in index order, so a worker's next row is
+    // usually in the block it already holds.
+    std::size_t blockIndex = guessIndex / FeedbackBlockCache<Length>::ROWS_PER_BLOCK;
+    if (blockIndex != scratch.feedbackBlockIndex)
+    {
+        scratch.feedbackBlock = feedbackBlocks->blockFor(guessIndex);
+        scratch.feedbackBlockIndex = blockIndex;
+    }
+    return static_cast<bool>(scratch.feedbackBlock);
+}
+
+template <std::size_t Length>
+template <typename Histogram>
+double WordleGame<Length>::scoreGuessWith(std::size_t guessIndex, Histogram &feedbackIdCounts, ScoringScratch &scratch) const
+{
+    feedbackIdCounts.fill(0);
+    if (feedbackMatrix)
+    {
+        const FeedbackCell<Length> *feedbackRow = feedbackMatrix->row(guessIndex);
+        for (auto answerIndex : candidates)
+        {
+            feedbackIdCounts[feedbackRow[answerIndex]]++;
+        }
+    }
+    else if (feedbackBlocks && heldFeedbackBlock(guessIndex, scratch))
+    {
+        const FeedbackCell<Length> *feedbackRow = scratch.feedbackBlock->row(guessIndex);
+        for (auto answerIndex : candidates)
+        {
+            feedbackIdCounts[feedbackRow[answerIndex]]++;
+        }
+    }
+    else
+    {
+        scratch.feedbackIds.resize(packedCandidates.paddedSize());
+        computeFeedbackIds((*guessWords)[guessIndex], packedCandidates, scratch.feedbackIds.data());
+        for (std::size_t i = 0; i < candidates.size(); i++)
+        {
+            feedbackIdCounts[scratch.feedbackIds[i]]++;
+        }
+    }
+    // each bucket holds exactly the candidates that pushing its feedback
+    // would leave, so the histogram is all the metrics need.
+    return scoringStrategy->score(feedbackIdCounts.data(), feedbackIdCounts.size(), static_cast<int32_t>(candidates.size()));
+}
+
+template <std::size_t Length>
+template <typename Histogram>
+double WordleGame<Length>::scoreFeedbackIds(
+    const std::vector<FeedbackCell<Length> > &feedbackIds,
+    Histogram &feedbackIdCounts) const
+{
+    feedbackIdCounts.fill(0);
+    for (auto feedbackId : feedbackIds)
+    {
+        feedbackIdCounts[feedbackId]++;
+    }
+    return scoringStrategy->score(feedbackIdCounts.data(), feedbackIdCounts.size(), static_cast<int32_t>(feedbackIds.size()));
+}
+
+template <std::size_t Length>
+std::size_t WordleGame<Length>::searchBestGuess(double &bestCost)
+{
+    PROFILE_SCOPE(PROFILE_LOOKAHEAD);
+    // rank every guess by its one-ply strategy score and look ahead from
+    // the best searchBreadth of them only.
+    std::size_t numWorkers = workerPool ? workerPool->numWorkers() : 1;
+    std::vector<std::size_t> &shortlist = searchScratch.shortlist;
+    std::vector<double> &scores = searchScratch.scores;
+    std::vector<ScoringScratch> &workerScratch = searchScratch.workers;
+    prefilterGuesses(candidates, guessPool, shortlist, searchScratch.coverage);
+    if (searchLimit)
+    {
+        prioritizeGuesses(shortlist, searchScratch.coverage);
+    }
+    // guesses the limit leaves unscored rank last.
+    scores.assign(shortlist.size(), std::numeric_limits<double>::infinity());
+    workerScratch.resize(numWorkers);
+    auto scoreGuesses = [&](std::size_t worker, std::size_t begin, std::size_t end)
+    {
+        if (begin > 0 && searchExpired())
+        {
+            return;
+        }
+        for (std::size_t i = begin; i < end; i++)
+        {
+            scores[i] = scoreGuess(shortlist[i], workerScratch[worker]);
+        }
+    };
+    if (workerPool)
+    {
+        workerPool->parallelFor(shortlist.size(), GUESS_CHUNK_SIZE, scoreGuesses);
+    }
+    else
+    {
+        for (std::size_t begin = 0; begin < shortlist.size(); begin += GUESS_CHUNK_SIZE)
+        {
+            scoreGuesses(0, begin, std::min<std::size_t>(begin + GUESS_CHUNK_SIZE, shortlist.size()));
+        }
+    }
+    for (auto &scratch : workerScratch)
+    {
+        scratch.releaseFeedbackBlock();
+    }
+    if (searchLimit)
+    {
+        // back in guess index order for rankGuesses.
+        std::vector<std::pair<std::size_t, double> > scored(shortlist.size());
+        for (std::size_t i = 0; i < shortlist.size(); i++)
+        {
+            scored[i] = std::make_pair(shortlist[i], scores[i]);
+        }
+        std::sort(scored.begin(), scored.end());
+        for (std::size_t i = 0; i < shortlist.size(); i++)
+        {
+            shortlist[i] = scored[i].first;
+            scores[i] = scored[i].second;
+        }
+    }
+    std::vector<std::size_t> rankedGuesses = rankGuesses(shortlist, scores, searchBreadth);
+
+    // the best complete cost so far, shared so every worker prunes against
+    // it. pruning keeps ties, so the result doesn't depend on timing.
+    std::atomic<double> sharedBestCost(std::numeric_limits<double>::infinity());
+    std::vector<double> costs(rankedGuesses.size());
+    auto searchGuesses = [&](std::size_t, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t rank = begin; rank < end; rank++)
+        {
+            double cost = lookaheadGuessCost(rankedGuesses[rank], candidates, guessPool, searchDepth, sharedBestCost.load());
+            costs[rank] = cost;
+            double best = sharedBestCost.load();
+            while (cost < best && !sharedBestCost.compare_exchange_weak(best, cost))
+            {
+            }
+        }
+    };
+    if (workerPool)
+    {
+        workerPool->parallelFor(rankedGuesses.size(), 1, searchGuesses);
+    }
+    else
+    {
+        searchGuesses(0, 0, rankedGuesses.size());
+    }
+
+    // if the limit stopped every lookahead, the best one-ply score stands.
+    bestCost = std::numeric_limits<double>::infinity();
+    std::size_t bestGuessIndex = rankedGuesses[0];
+    for (std::size_t rank = 0; rank < rankedGuesses.size(); rank++)
+    {
+        if (costs[rank] == std::numeric_limits<double>::infinity())
+        {
+            continue;
+        }
+        if (costs[rank] < bestCost || (costs[rank] == bestCost && rankedGuesses[rank] < bestGuessIndex))
+        {
+            bestCost = costs[rank];
+            bestGuessIndex = rankedGuesses[rank];
+        }
+    }
+    return bestGuessIndex;
+}
+
+template <std::size_t Length>
+std::vector<std::size_t> WordleGame<Length>::rankGuesses(
+    const std::vector<std::size_t> &guessIndices,
+    const std::vector<double> &scores,
+    std::size_t limit)
+{
+    // positions into guessIndices, which is in ascending order, so ties
+    // between positions are ties between guess indices too.
+    std::vector<std::size_t> order(scores.size());
+    for (std::size_t i = 0; i < scores.size(); i++)
+    {
+        order[i] = i;
+    }
+    limit = std::min(limit, order.size());
+    std::partial_sort(
+        order.begin(), order.begin() + limit, order.end(),
+        [&](std::size_t left, std::size_t right)
+        {
+            return scores[left] < scores[right] || (scores[left] == scores[right] && left < right);
+        });
+    std::vector<std::size_t> rankedGuesses(limit);
+    for (std::size_t rank = 0; rank < limit; rank++)
+    {
+        rankedGuesses[rank] = guessIndices[order[rank]];
+    }
+    return rankedGuesses;
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::prefilterGuesses(
+    const std::vector<uint32_t> &candidateSet,
+    const std::vector<uint32_t> &guessIndices,
+    std::vector<std::size_t> &shortlist,
+    std::vector<int32_t> &coverage) const
+{
+    shortlist.assign(guessIndices.begin(), guessIndices.end());
+    if (guessPrefilterSize == 0 || guessPrefilterSize >= guessIndices.size())
+    {
+        return;
+    }
+    computeGuessCoverage(candidateSet, guessIndices, coverage);
+    std::nth_element(
+        shortlist.begin(), shortlist.begin() + guessPrefilterSize, shortlist.end(),
+        [&](std::size_t left, std::size_t right)
+        {
+            return coverage[left] > coverage[right] || (coverage[left] == coverage[right] && left < right);
+        });
+    shortlist.resize(guessPrefilterSize);
+    std::sort(shortlist.begin(), shortlist.end());
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::computeGuessCoverage(
+    const std::vector<uint32_t> &candidateSet,
+    const std::vector<uint32_t> &guessIndices,
+    std::vector<int32_t> &coverage) const
+{
+    int32_t letterCounts[NUMBER_OF_LETTERS] = {0};
+    int32_t positionCounts[Length][NUMBER_OF_LETTERS] = {{0}};
+    for (auto answerIndex : candidateSet)
+    {
+        const Word<Length> &answer = (*answerWords)[answerIndex];
+        for (uint32_t mask = answer.letterMask(); mask != 0; mask &= mask - 1)
+        {
+            letterCounts[__builtin_ctz(mask)]++;
+        }
+        for (std::size_t i = 0; i < Length; i++)
+        {
+            positionCounts[i][answer.letterCode(i)]++;
+        }
+    }
+    // a letter, or a letter in a position, tells the candidates apart best
+    // when about half of them have it.
+    int32_t numCandidates = static_cast<int32_t>(candidateSet.size());
+    coverage.resize(guessWords->size());
+    for (auto guessIndex : guessIndices)
+    {
+        const Word<Length> &guess = (*guessWords)[guessIndex];
+        int32_t guessCoverage = 0;
+        for (uint32_t mask = guess.letterMask(); mask != 0; mask &= mask - 1)
+        {
+            int32_t count = letterCounts[__builtin_ctz(mask)];
+            guessCoverage += std::min(count, numCandidates - count);
+        }
+        for (std::size_t i = 0; i < Length; i++)
+        {
+            int32_t count = positionCounts[i][guess.letterCode(i)];
+            guessCoverage += std::min(count, numCandidates - count);
+        }
+        coverage[guessIndex] = guessCoverage;
+    }
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::prioritizeGuesses(std::vector<std::size_t> &shortlist, std::vector<int32_t> &coverage) const
+{
+    computeGuessCoverage(candidates, guessPool, coverage);
+    std::sort(
+        shortlist.begin(), shortlist.end(),
+        [&](std::size_t left, std::size_t right)
+        {
+            return coverage[left] > coverage[right] || (coverage[left] == coverage[right] && left < right);
+        });
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::computeCandidateFeedbackIds(
+    std::size_t guessIndex,
+    const std::vector<uint32_t> &candidateSet,
+    std::vector<FeedbackCell<Length> > &feedbackIds) const
+{
+    feedbackIds.resize(candidateSet.size());
+    if (feedbackMatrix)
+    {
+        const FeedbackCell<Length> *feedbackRow = feedbackMatrix->row(guessIndex);
+        for (std::size_t i = 0; i < candidateSet.size(); i++)
+        {
+            feedbackIds[i] = feedbackRow[candidateSet[i]];
+        }
+        return;
+    }
+    std::shared_ptr<const typename FeedbackBlockCache<Length>::Block> block;
+    if (feedbackBlocks && (block = feedbackBlocks->cachedBlock(guessIndex)))
+    {
+        const FeedbackCell<Length> *feedbackRow = block->row(guessIndex);
+        for (std::size_t i = 0; i < candidateSet.size(); i++)
+        {
+            feedbackIds[i] = feedbackRow[candidateSet[i]];
+        }
+        return;
+    }
+    const Word<Length> &guess = (*guessWords)[guessIndex];
+    for (std::size_t i = 0; i < candidateSet.size(); i++)
+    {
+        feedbackIds[i] = static_cast<FeedbackCell<Length> >(computeFeedbackId(guess, (*answerWords)[candidateSet[i]]));
+    }
+}
+
+template <std::size_t Length>
+double WordleGame<Length>::lookaheadSetCost(
+    const std::vector<uint32_t> &candidateSet,
+    const std::vector<uint32_t> &guessIndices,
+    int32_t depth,
+    double cutoff) const
+{
+    double bestCost = std::numeric_limits<double>::infinity();
+    if (candidateSet.size() <= 2)
+    {
+        // guessing a candidate is optimal and the bound is exact here.
+        bestCost = minimumExpectedGuesses<Length>(candidateSet.size());
+        return bestCost <= cutoff ? bestCost : std::numeric_limits<double>::infinity();
+    }
+    std::vector<std::size_t> guessOrder;
+    std::vector<int32_t> coverage;
+    prefilterGuesses(candidateSet, guessIndices, guessOrder, coverage);
+    if (depth > 1)
+    {
+        ScoringScratch scratch;
+        std::vector<FeedbackCell<Length> > feedbackIds;
+        std::vector<double> scores(guessOrder.size());
+        for (std::size_t i = 0; i < guessOrder.size(); i++)
+        {
+            computeCandidateFeedbackIds(guessOrder[i], candidateSet, feedbackIds);
+            scores[i] = candidateSet.size() > UINT16_MAX ? scoreFeedbackIds(feedbackIds, scratch.wideFeedbackIdCounts)
+                                                         : scoreFeedbackIds(feedbackIds, scratch.feedbackIdCounts);
+        }
+        guessOrder = rankGuesses(guessOrder, scores, searchBreadth);
+    }
+    // the last turn only sums bounds, cheap enough to try every guess on
+    // the shortlist.
+    for (auto guessIndex : guessOrder)
+    {
+        double cost = lookaheadGuessCost(guessIndex, candidateSet, guessIndices, depth, std::min(cutoff, bestCost));
+        bestCost = std::min(bestCost, cost);
+    }
+    return bestCost;
+}
+
+template <std::size_t Length>
+double WordleGame<Length>::lookaheadGuessCost(
+    std::size_t guessIndex,
+    const std::vector<uint32_t> &candidateSet,
+    const std::vector<uint32_t> &guessIndices,
+    int32_t depth,
+    double cutoff) const
+{
+    // a little slack so rounding in the bounds never prunes a tie.
+    const double pruneSlack = 1e-9;
+    if (searchExpired())
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    const int32_t solvedFeedbackId = maxFeedbackId(Length);
+    double numCandidates = static_cast<double>(candidateSet.size());
+
+    std::vector<FeedbackCell<Length> > feedbackIds;
+    computeCandidateFeedbackIds(guessIndex, candidateSet, feedbackIds);
+    std::vector<int32_t> bucketStarts(maxFeedbackId(Length) + 2, 0);
+    for (auto feedbackId : feedbackIds)
+    {
+        bucketStarts[feedbackId + 1]++;
+    }
+    // this guess, then at least the bound for every bucket it leaves open.
+    double cost = 1;
+    for (int32_t feedbackId = 0; feedbackId <= maxFeedbackId(Length); feedbackId++)
+    {
+        int32_t bucketSize = bucketStarts[feedbackId + 1];
+        if (feedbackId != solvedFeedbackId && bucketSize > 0)
+        {
+            cost += bucketSize / numCandidates * minimumExpectedGuesses<Length>(bucketSize);
+        }
+    }
+    if (cost > cutoff + pruneSlack)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (depth <= 1)
+    {
+        return cost;
+    }
+
+    for (int32_t feedbackId = 0; feedbackId <= maxFeedbackId(Length); feedbackId++)
+    {
+        bucketStarts[feedbackId + 1] += bucketStarts[feedbackId];
+    }
+    std::vector<uint32_t> buckets(candidateSet.size());
+    std::vector<int32_t> bucketEnds(bucketStarts.begin(), bucketStarts.end() - 1);
+    for (std::size_t i = 0; i < candidateSet.size(); i++)
+    {
+        buckets[bucketEnds[feedbackIds[i]]++] = candidateSet[i];
+    }
+    // replace each bucket's bound with its searched cost, stopping as soon
+    // as the total can no longer beat the cutoff.
+    std::vector<uint32_t> bucket;
+    std::vector<uint32_t> bucketGuessIndices;
+    for (int32_t feedbackId = 0; feedbackId < maxFeedbackId(Length); feedbackId++)
+    {
+        int32_t bucketSize = bucketStarts[feedbackId + 1] - bucketStarts[feedbackId];
+        if (bucketSize <= 2)
+        {
+            continue;
+        }
+        double weight = bucketSize / numCandidates;
+        double bound = minimumExpectedGuesses<Length>(bucketSize);
+        bucket.assign(buckets.begin() + bucketStarts[feedbackId], buckets.begin() + bucketStarts[feedbackId + 1]);
+        double bucketCutoff = bound + (cutoff + pruneSlack - cost) / weight;
+        if (hardMode)
+        {
+            // later turns are held to this guess's hints as well.
+            filterHardModeGuesses(
+                *guessWords, GuessFeedback<Length>((*guessWords)[guessIndex], feedbackId), guessIndices, bucketGuessIndices);
+        }
+        double bucketCost = lookaheadSetCost(bucket, hardMode ? bucketGuessIndices : guessIndices, depth - 1, bucketCutoff);
+        cost += weight * (bucketCost - bound);
+        if (cost > cutoff + pruneSlack)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+    }
+    return cost;
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::pushFeedback(GuessFeedback<Length> guessFeedback)
+{
+    PROFILE_SCOPE(PROFILE_FILTERING);
+    if (decisionTree)
+    {
+        treeNodes.push_back(nextTreeNode(guessFeedback));
+    }
+    feedbacks.push_back(guessFeedback);
+    if (hardMode)
+    {
+        guessPoolHistory.push_back(std::move(guessPool));
+        filterHardModeGuesses(*guessWords, guessFeedback, guessPoolHistory.back(), guessPool);
+    }
+    FeedbackConstraints<Length> added(guessFeedback);
+    constraintHistory.push_back(constraints);
+    constraints.merge(added);
+
+    // only the new feedback needs checking, everything left in the candidate
+    // set is already consistent with the earlier ones.
+    candidateHistory.push_back(std::move(candidates));
+    candidates.clear();
+    if (!spareCandidateSets.empty())
+    {
+        candidates.swap(spareCandidateSets.back());
+        spareCandidateSets.pop_back();
+    }
+    candidates.reserve(candidateHistory.back().size());
+    PROFILE_COUNT(PROFILE_CONSISTENCY_CHECKS, candidateHistory.back().size());
+    for (auto answerIndex : candidateHistory.back())
+    {
+        if (added.allows((*answerWords)[answerIndex]))
+        {
+            candidates.push_back(answerIndex);
+        }
+    }
+    packedCandidates.assign(*answerWords, candidates);
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::popFeedback()
+{
+    if (decisionTree)
+    {
+        treeNodes.pop_back();
+    }
+    feedbacks.pop_back();
+    if (hardMode)
+    {
+        guessPool = std::move(guessPoolHistory.back());
+        guessPoolHistory.pop_back();
+    }
+    constraints = constraintHistory.back();
+    constraintHistory.pop_back();
+    candidates.clear();
+    spareCandidateSets.push_back(std::move(candidates));
+    candidates = std::move(candidateHistory.back());
+    candidateHistory.pop_back();
+    packedCandidates.assign(*answerWords, candidates);
+}
+
+template <std::size_t Length>
+void WordleGame<Length>::restart()
+{
+    while (!feedbacks.empty())
+    {
+        popFeedback();
+    }
+}
+
+template <std::size_t Length>
+bool WordleGame<Length>::isPossibleAnswer(Word<Length> word) const
+{
+    return constraints.allows(word);
+}
+
+#define INSTANTIATE_WORDLE_GAME(Length) template class WordleGame<Length>;
+
+WORDLE_FOR_EACH_WORD_LENGTH(INSTANTIATE_WORDLE_GAME)
@@ -0,0 +1,270 @@
+#ifndef WORDLE_WORDLE_GAME_H
+#define WORDLE_WORDLE_GAME_H
+
+#include "wordle/DecisionTree.h"
+#include "wordle/Feedback.h"
+#include "wordle/FeedbackConstraints.h"
+#include "wordle/FeedbackKernels.h"
+#include "wordle/FeedbackMatrix.h"
+#include "wordle/ScoringStrategy.h"
+#include "wordle/TranspositionCache.h"
+#include "wordle/WorkerPool.h"
+#include "wordle/Word.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// when an anytime search has to stop: at deadline, or as soon as another
+// thread sets *cancelled. no deadline is time_point::max(), no token NULL.
+struct SearchLimit
+{
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool> *cancelled;
+
+    SearchLimit(std::chrono::steady_clock::time_point searchDeadline, const std::atomic<bool> *cancelToken)
+        : deadline(searchDeadline), cancelled(cancelToken)
+    {
+    }
+    bool expired() const
+    {
+        return (cancelled && cancelled->load(std::memory_order_relaxed)) || std::chrono::steady_clock::now() >= deadline;
+    }
+};
+
+// the guess an anytime search settled on, and whether it got to score
+// every guess it would have without a limit.
+template <std::size_t Length>
+struct GuessResult
+{
+    Word<Length> guess;
+    bool complete;
+};
+
+// one game of Length-letter words.
+template <std::size_t Length>
+class WordleGame
+{
+
+public:
+    WordleGame(
+        std::unique_ptr<std::vector<Word<Length> > > guessWords,
+        std::unique_ptr<std::vector<Word<Length> > > answerWords);
+    ~WordleGame();
+
+    // a game with no feedback yet that shares this game's immutable state:
+    // word lists, feedback matrix and scoring strategy. the worker pool is
+    // not shared.
+    std::unique_ptr<WordleGame<Length> > newGame() const;
+
+    bool isPossibleAnswer(Word<Length> word) const;
+    Word<Length> getGuess();
+    // getGuess that stops once limit expires and returns the best guess
+    // scored by then. guesses are scored best letter coverage first, so the
+    // likely winners come early, and the first few are always scored. only
+    // complete results go into the transposition cache.
+    GuessResult<Length> getGuessWithin(const SearchLimit &limit);
+    // getGuess for each of games, which must all come from one prototype's
+    // newGame, into guesses. games searching at depth 1 are scored together:
+    // each guess's matrix row is read once and counted against every game's
+    // candidates while it is still in cache. pool may be NULL to score on
+    // the calling thread. games searching deeper run searchBestGuess one at
+    // a time first, each on its own pool rather than pool.
+    static void getGuesses(
+        const std::vector<WordleGame<Length> *> &games,
+        std::vector<Word<Length> > &guesses,
+        WorkerPool *pool);
+    void pushFeedback(GuessFeedback<Length> guessFeedback);
+    void popFeedback();
+    // back to no feedback, keeping the buffers of the game just played.
+    void restart();
+    void enableFeedbackMatrix();
+    // the matrix computed a block of rows at a time as guesses are scored,
+    // keeping at most maxBytes of blocks, for dictionaries whose full matrix
+    // would not fit. replaces any feedback matrix.
+    void enableFeedbackBlocks(std::size_t maxBytes);
+    void setFeedbackMatrix(std::shared_ptr<const FeedbackMatrix<Length> > matrix);
+    std::shared_ptr<const FeedbackMatrix<Length> > getFeedbackMatrix() const;
+    std::shared_ptr<FeedbackBlockCache<Length> > getFeedbackBlocks() const;
+    int32_t numAnswers() const;
+    std::shared_ptr<const std::vector<Word<Length> > > getAnswerWords() const;
+    std::vector<Word<Length> > getPossibleAnswers() const;
+    std::size_t numFeedbacks() const;
+    void setWorkerPool(std::shared_ptr<WorkerPool> pool);
+    void setScoringStrategy(std::shared_ptr<const ScoringStrategy> strategy);
+    // follow tree while the feedback history stays on it instead of
+    // searching. NULL turns lookups off.
+    void setDecisionTree(std::shared_ptr<const DecisionTree<Length> > tree);
+    // the settings that decide which guess getGuess returns, to tell apart
+    // precomputed results that are only valid for one configuration.
+    std::string configurationName() const;
+    // depth 1 picks the guess with the best strategy score. deeper searches
+    // pick the guess with the fewest expected guesses over that many turns,
+    // trying only the breadth best-scoring guesses on each turn but the
+    // last.
+    void setSearchDepth(int32_t depth, int32_t breadth);
+    // score only the size guesses with the best cheap letter-coverage
+    // score exactly. 0 scores every guess.
+    void setGuessPrefilter(std::size_t size);
+    // hard mode only picks guesses that use every hint revealed so far.
+    void setHardMode(bool enabled);
+    std::shared_ptr<const std::vector<Word<Length> > > getGuessWords() const;
+    void setTranspositionCache(std::shared_ptr<TranspositionCache> cache);
+    static GuessFeedback<Length> computeFeedback(const Word<Length> &guess, const Word<Length> &solution);
+    static int32_t computeFeedbackId(const Word<Length> &guess, const Word<Length> &solution);
+
+private:
+    // per-worker buffers reused from one scored guess to the next.
+    struct ScoringScratch
+    {
+        FeedbackHistogram<Length> feedbackIdCounts;
+        WideFeedbackHistogram<Length> wideFeedbackIdCounts;
+        std::vector<FeedbackCell<Length> > feedbackIds;
+        // the block of the last row looked up in feedbackBlocks and its
+        // index, so the rows after it don't go back to the cache. NULL when
+        // the cache did not have it.
+        std::shared_ptr<const typename FeedbackBlockCache<Length>::Block> feedbackBlock;
+        std::size_t feedbackBlockIndex;
+
+        ScoringScratch() : feedbackBlockIndex(SIZE_MAX)
+        {
+        }
+        void releaseFeedbackBlock()
+        {
+            feedbackBlock.reset();
+            feedbackBlockIndex = SIZE_MAX;
+        }
+    };
+    // buffers one getGuess leaves for the next, so turns after the first
+    // don't allocate.
+    struct SearchScratch
+    {
+        std::vector<ScoringScratch> workers;
+        std::vector<double> workerBestScores;
+        std::vector<std::size_t> workerBestGuessIndices;
+        std::vector<std::size_t> shortlist;
+        std::vector<int32_t> coverage;
+        std::vector<double> scores;
+    };
+
+    WordleGame(
+        std::shared_ptr<const std::vector<Word<Length> > > guessWords,
+        std::shared_ptr<const std::vector<Word<Length> > > answerWords);
+    static std::shared_ptr<const std::vector<Word<Length> > > appendAnswers(
+        std::unique_ptr<std::vector<Word<Length> > > guessWords,
+        const std::vector<Word<Length> > &answerWords);
+    void resetCandidates();
+    void resetGuessPool();
+    // the guesses from guessIndices that use the hints in guessFeedback.
+    static void filterHardModeGuesses(
+        const std::vector<Word<Length> > &guessWords,
+        const GuessFeedback<Length> &guessFeedback,
+        const std::vector<uint32_t> &guessIndices,
+        std::vector<uint32_t> &result);
+    int32_t nextTreeNode(const GuessFeedback<Length> &guessFeedback) const;
+    TranspositionCache::Key candidateSetKey() const;
+    // the guess needing no search, from the decision tree, the opening, a
+    // candidate when at most two are left, or the transposition cache.
+    // false when there is none, with cacheKey set for rememberGuess.
+    bool findKnownGuess(Word<Length> &guess, TranspositionCache::Key &cacheKey) const;
+    void rememberGuess(const TranspositionCache::Key &cacheKey, std::size_t guessIndex, double score) const;
+    double scoreGuess(std::size_t guessIndex, ScoringScratch &scratch) const;
+    // true with scratch holding guessIndex's block from feedbackBlocks, false
+    // when the cache does not have it.
+    bool heldFeedbackBlock(std::size_t guessIndex, ScoringScratch &scratch) const;
+    // scoreGuess with the histogram wide enough for the candidate count.
+    template <typename Histogram>
+    double scoreGuessWith(std::size_t guessIndex, Histogram &feedbackIdCounts, ScoringScratch &scratch) const;
+    template <typename Histogram>
+    double scoreFeedbackIds(const std::vector<FeedbackCell<Length> > &feedbackIds, Histogram &feedbackIdCounts) const;
+    void updateConfigurationHash();
+    // getGuess under searchLimit, NULL for none.
+    GuessResult<Length> searchGuess();
+    std::size_t findBestGuess(double &bestScore);
+    std::size_t searchBestGuess(double &bestCost);
+    // true, and remembered in searchStopped, once searchLimit has expired.
+    bool searchExpired() const;
+    // the limit guesses from guessIndices with the lowest scores, best
+    // first.
+    static std::vector<std::size_t> rankGuesses(
+        const std::vector<std::size_t> &guessIndices,
+        const std::vector<double> &scores,
+        std::size_t limit);
+    // the guess indices from guessIndices worth scoring exactly for
+    // candidateSet, ascending.
+    void prefilterGuesses(
+        const std::vector<uint32_t> &candidateSet,
+        const std::vector<uint32_t> &guessIndices,
+        std::vector<std::size_t> &shortlist,
+        std::vector<int32_t> &coverage) const;
+    // cheap letter-coverage scores for candidateSet of the guesses in
+    // guessIndices, indexed by guess index; higher is better.
+    void computeGuessCoverage(
+        const std::vector<uint32_t> &candidateSet,
+        const std::vector<uint32_t> &guessIndices,
+        std::vector<int32_t> &coverage) const;
+    // reorders shortlist best coverage first, ties by guess index.
+    void prioritizeGuesses(std::vector<std::size_t> &shortlist, std::vector<int32_t> &coverage) const;
+    void computeCandidateFeedbackIds(
+        std::size_t guessIndex,
+        const std::vector<uint32_t> &candidateSet,
+        std::vector<FeedbackCell<Length> > &feedbackIds) const;
+    // expected guesses to solve candidateSet, or infinity once that is
+    // known to be worse than cutoff, guessing from guessIndices.
+    double lookaheadSetCost(
+        const std::vector<uint32_t> &candidateSet,
+        const std::vector<uint32_t> &guessIndices,
+        int32_t depth,
+        double cutoff) const;
+    double lookaheadGuessCost(
+        std::size_t guessIndex,
+        const std::vector<uint32_t> &candidateSet,
+        const std::vector<uint32_t> &guessIndices,
+        int32_t depth,
+        double cutoff) const;
+
+    const std::shared_ptr<const std::vector<Word<Length> > > guessWords;
+    const std::shared_ptr<const std::vector<Word<Length> > > answerWords;
+    std::shared_ptr<const FeedbackMatrix<Length> > feedbackMatrix;
+    std::shared_ptr<FeedbackBlockCache<Length> > feedbackBlocks;
+    std::shared_ptr<WorkerPool> workerPool;
+    std::shared_ptr<const ScoringStrategy> scoringStrategy;
+    int32_t searchDepth;
+    int32_t searchBreadth;
+    std::size_t guessPrefilterSize;
+    bool hardMode;
+    // checksum of configurationName, seeding the transposition cache keys.
+    uint64_t configurationHash;
+    std::vector<GuessFeedback<Length> > feedbacks;
+    // the feedbacks compiled into one check, plus the checks as they were
+    // before each pushFeedback.
+    FeedbackConstraints<Length> constraints;
+    std::vector<FeedbackConstraints<Length> > constraintHistory;
+    // indices into answerWords of the answers consistent with every feedback
+    // so far, plus the sets as they were before each pushFeedback.
+    std::vector<uint32_t> candidates;
+    std::vector<std::vector<uint32_t> > candidateHistory;
+    // sets popped off the history, kept for their capacity.
+    std::vector<std::vector<uint32_t> > spareCandidateSets;
+    // indices into guessWords of the guesses getGuess picks from, ascending:
+    // all of them, or in hard mode the ones that use every hint so far. hard
+    // mode also keeps the pools as they were before each pushFeedback.
+    std::vector<uint32_t> guessPool;
+    std::vector<std::vector<uint32_t> > guessPoolHistory;
+    // the candidates again, laid out for the batched feedback kernels.
+    PackedAnswers<Length> packedCandidates;
+    // decision tree node for the current history and each earlier one, or
+    // DecisionTree::NO_NODE once the history has left the tree.
+    std::shared_ptr<const DecisionTree<Length> > decisionTree;
+    std::vector<int32_t> treeNodes;
+    std::shared_ptr<TranspositionCache> transpositionCache;
+    SearchScratch searchScratch;
+    // the limit of the getGuessWithin in progress, and whether it cut the
+    // search short.
+    const SearchLimit *searchLimit;
+    mutable std::atomic<bool> searchStopped;
+};
+
+#endif
@@ -0,0 +1,138 @@
+#include "wordle/WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+WorkerPool::WorkerPool(std::size_t numThreads) : stopping(false)
+{
+    // the thread calling parallelFor does a share of the work itself.
+    for (std::size_t i = 1; i < numThreads; i++)
+    {
+        threads.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+std::size_t WorkerPool::numWorkers() const
+{
+    return threads.size() + 1;
+}
+
+void WorkerPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void WorkerPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]
+                               { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void WorkerPool::parallelFor(
+    std::size_t count,
+    std::size_t chunkSize,
+    const std::function<void(std::size_t, std::size_t, std::size_t)> &body)
+{
+    struct State
+    {
+        std::function<void(std::size_t, std::size_t, std::size_t)> body;
+        std::size_t count;
+        std::size_t chunkSize;
+        std::atomic<std::size_t> nextIndex;
+        std::atomic<std::size_t> activeHelpers;
+        std::mutex mutex;
+        std::condition_variable helpersDone;
+        std::exception_ptr error;
+
+        void run(std::size_t worker)
+        {
+            while (true)
+            {
+                std::size_t begin = nextIndex.fetch_add(chunkSize);
+                if (begin >= count)
+                {
+                    return;
+                }
+                try
+                {
+                    body(worker, begin, std::min(count, begin + chunkSize));
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                    nextIndex = count;
+                }
+            }
+        }
+    };
+
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    std::shared_ptr<State> state(new State);
+    state->body = body;
+    state->count = count;
+    state->chunkSize = chunkSize;
+    state->nextIndex = 0;
+    state->activeHelpers = 0;
+
+    std::size_t numHelpers = std::min(threads.size(), (count + chunkSize - 1) / chunkSize);
+    for (std::size_t helper = 1; helper <= numHelpers; helper++)
+    {
+        // a helper that only starts once the range is used up never calls
+        // body, so the caller does not need to wait for it to be scheduled.
+        submit([state, helper]
+               {
+                   state->activeHelpers++;
+                   state->run(helper);
+                   std::lock_guard<std::mutex> lock(state->mutex);
+                   if (--state->activeHelpers == 0)
+                   {
+                       state->helpersDone.notify_all();
+                   } });
+    }
+    state->run(0);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->helpersDone.wait(lock, [&state]
+                            { return state->activeHelpers == 0; });
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
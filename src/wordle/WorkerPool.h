@@ -0,0 +1,41 @@
+#ifndef WORDLE_WORKER_POOL_H
+#define WORDLE_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of threads that run submitted tasks. parallelFor hands out a
+// range in small chunks from a shared counter, so a worker that finishes
+// early keeps taking chunks instead of sitting idle.
+class WorkerPool
+{
+public:
+    WorkerPool(std::size_t numThreads);
+    ~WorkerPool();
+
+    // number of threads that take part in parallelFor, counting the caller.
+    std::size_t numWorkers() const;
+    void submit(std::function<void()> task);
+    // runs body(worker, begin, end) over [0, count). worker is in
+    // [0, numWorkers()) and no two concurrent calls share one.
+    void parallelFor(
+        std::size_t count,
+        std::size_t chunkSize,
+        const std::function<void(std::size_t, std::size_t, std::size_t)> &body);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::deque<std::function<void()> > tasks;
+    bool stopping;
+};
+
+#endif